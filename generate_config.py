@@ -50,6 +50,7 @@ def generate_config_h(config, output_path):
         'OLED_RESET_PIN': '-1',
         'OLED_SDA_PIN': '21',
         'OLED_SCL_PIN': '22',
+        'OLED_I2C_CLOCK_HZ': '400000',
         'POT_X_PIN': '34',
         'POT_Y_PIN': '35',
         'BTN_SELECT': '27',
@@ -58,7 +59,10 @@ def generate_config_h(config, output_path):
         'POT_SENSITIVITY': '3',
         'MOVE_DELAY': '150',
         'SLEEP_DURATION_SECONDS': '300',
-        'WIFI_TIMEOUT_MS': '15000'
+        'WIFI_TIMEOUT_MS': '15000',
+        'UPLINK_URL': '"http://192.168.1.10:8080/telemetry"',
+        'TIME_SYNC_HOURS': '24',
+        'TRACE_DUMP': '0'
     }
     
     # Merge config with defaults
@@ -78,6 +82,7 @@ def generate_config_h(config, output_path):
 #define OLED_RESET_PIN {final_config['OLED_RESET_PIN']}        // Reset pin (-1 if no reset pin)
 #define OLED_SDA_PIN {final_config['OLED_SDA_PIN']}          // I2C SDA pin
 #define OLED_SCL_PIN {final_config['OLED_SCL_PIN']}          // I2C SCL pin
+#define OLED_I2C_CLOCK_HZ {final_config['OLED_I2C_CLOCK_HZ']}  // I2C clock while sending frames
 
 // Display Dimensions
 #define SCREEN_WIDTH 128
@@ -125,6 +130,24 @@ def generate_config_h(config, output_path):
 #define WIFI_NAMESPACE "wifi-creds"   // Preferences namespace for WiFi credentials
 #define WIFI_CONNECTION_TIMEOUT 10000 // Default WiFi connection timeout in ms
 
+// ========================================
+// TELEMETRY
+// ========================================
+
+#define UPLINK_URL {final_config['UPLINK_URL']}  // Batched readings are POSTed here
+
+// ========================================
+// TIME
+// ========================================
+
+#define TIME_SYNC_HOURS {final_config['TIME_SYNC_HOURS']}  // Network time sync interval; the RTC covers the wakes between
+
+// ========================================
+// DIAGNOSTICS
+// ========================================
+
+#define TRACE_DUMP {final_config['TRACE_DUMP']}  // 1: record hot-path spans and dump them over Serial before each sleep
+
 #endif // CONFIG_H
 """
     
@@ -12,6 +12,7 @@
 #define OLED_SDA_PIN 8
 #define OLED_SCL_PIN 9
 #define OLED_RESET_PIN -1
+#define OLED_I2C_CLOCK_HZ 400000
 
 // Display Settings
 #define SCREEN_WIDTH 128
@@ -32,6 +33,15 @@
 #define SLEEP_DURATION_SECONDS 300
 #define WIFI_TIMEOUT_MS 15000
 
+// Telemetry
+#define UPLINK_URL "http://192.168.1.10:8080/telemetry"
+
+// Time
+#define TIME_SYNC_HOURS 24
+
+// Diagnostics
+#define TRACE_DUMP 0
+
 // Special Characters for KeyInput
 #define REMOVE_CHAR 127
 #define LEFT_CHAR 128
@@ -0,0 +1,96 @@
+#include "Axis.h"
+
+Axis::Axis(uint8_t pin) : pin(pin) {
+  reset();
+}
+
+void Axis::reset() {
+  window_pos = 0;
+  window_fill = 0;
+  filtered = (int32_t)POT_CENTER << 4;
+  direction = 0;
+  next_repeat = 0;
+  repeat_interval = MOVE_DELAY;
+}
+
+void Axis::sample() {
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < AXIS_OVERSAMPLE; i++) {
+    sum += analogRead(pin);
+  }
+  uint16_t reading = sum / AXIS_OVERSAMPLE;
+
+  if (window_fill == 0) {
+    // Start from the first reading rather than ramping in from center
+    for (uint8_t i = 0; i < AXIS_WINDOW; i++) {
+      window[i] = reading;
+    }
+    window_fill = AXIS_WINDOW;
+    filtered = (int32_t)reading << 4;
+    return;
+  }
+
+  window[window_pos] = reading;
+  window_pos = (window_pos + 1) % AXIS_WINDOW;
+
+  int32_t target = (int32_t)median() << 4;
+  filtered += (target - filtered) >> AXIS_IIR_SHIFT;
+}
+
+// Insertion sort of a copy; the window is only a handful of samples
+uint16_t Axis::median() const {
+  uint16_t sorted[AXIS_WINDOW];
+  for (uint8_t i = 0; i < AXIS_WINDOW; i++) {
+    uint16_t value = window[i];
+    uint8_t j = i;
+    while (j > 0 && sorted[j - 1] > value) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = value;
+  }
+  return sorted[AXIS_WINDOW / 2];
+}
+
+int Axis::update(unsigned long now) {
+  int16_t position = getPosition();
+  int16_t magnitude = abs(position);
+  int8_t side = position < 0 ? -1 : 1;
+
+  // Released, or swung straight through to the other side
+  if (direction != 0 && (magnitude < AXIS_RELEASE || side != direction)) {
+    direction = 0;
+  }
+
+  if (direction == 0) {
+    if (magnitude <= AXIS_ENGAGE) {
+      return 0;
+    }
+    direction = side;
+    repeat_interval = MOVE_DELAY;
+    next_repeat = now + AXIS_REPEAT_DELAY_MS;
+    return direction;
+  }
+
+  if ((long)(now - next_repeat) < 0) {
+    return 0;
+  }
+
+  // Deeper deflection divides the interval by up to (1 + 3 / POT_SENSITIVITY)
+  int depth = (magnitude - AXIS_ENGAGE) * 4 / (POT_CENTER - AXIS_ENGAGE);
+  depth = constrain(depth, 0, 3);
+  uint16_t interval = repeat_interval * POT_SENSITIVITY / (POT_SENSITIVITY + depth);
+  next_repeat = now + max(interval, (uint16_t)AXIS_REPEAT_MIN_MS);
+
+  // Accelerate by a quarter per repeat while held
+  repeat_interval = max((uint16_t)(repeat_interval - (repeat_interval >> 2)), (uint16_t)AXIS_REPEAT_MIN_MS);
+  return direction;
+}
+
+int16_t Axis::getPosition() const {
+  return (int16_t)(filtered >> 4) - POT_CENTER;
+}
+
+int8_t Axis::getDirection() const {
+  return direction;
+}
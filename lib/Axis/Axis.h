@@ -0,0 +1,56 @@
+#ifndef AXIS_H
+#define AXIS_H
+
+#include <Arduino.h>
+#include "configs.h"
+
+#define AXIS_OVERSAMPLE 4                          // ADC reads averaged into each sample
+#define AXIS_WINDOW 5                              // Samples in the median window
+#define AXIS_IIR_SHIFT 2                           // Smoothing: y += (x - y) / 4
+#define AXIS_ENGAGE ((POT_CENTER * 2) / 5)         // Deflection that counts as a push
+#define AXIS_RELEASE (AXIS_ENGAGE - POT_DEADZONE)  // Back to neutral (hysteresis)
+#define AXIS_REPEAT_DELAY_MS (MOVE_DELAY * 2)      // Hold before auto-repeat starts
+#define AXIS_REPEAT_MIN_MS 30                      // Fastest auto-repeat interval
+
+// One potentiometer as a stream of -1/+1 steps.
+// sample() takes AXIS_OVERSAMPLE ADC reads into a ring of AXIS_WINDOW
+// samples; the median of the ring rejects single-read spikes and an IIR
+// stage smooths what is left. update() turns the filtered deflection from
+// POT_CENTER into steps: one on push, then auto-repeat after
+// AXIS_REPEAT_DELAY_MS that speeds up the longer the pot is held and the
+// further it is deflected (scaled by POT_SENSITIVITY, higher = slower).
+class Axis {
+private:
+  uint8_t pin;
+
+  // Filter state
+  uint16_t window[AXIS_WINDOW];
+  uint8_t window_pos;
+  uint8_t window_fill;
+  int32_t filtered;              // IIR output in 1/16 ADC counts
+
+  // Auto-repeat state
+  int8_t direction;              // -1, 0 or +1 while pushed
+  unsigned long next_repeat;
+  uint16_t repeat_interval;
+
+  uint16_t median() const;
+
+public:
+  // Constructor
+  explicit Axis(uint8_t pin);
+
+  void reset();
+
+  // Take one oversampled reading (input task)
+  void sample();
+
+  // Step due at this time: -1, 0 or +1
+  int update(unsigned long now);
+
+  // Status methods
+  int16_t getPosition() const;   // Filtered deflection from POT_CENTER
+  int8_t getDirection() const;
+};
+
+#endif // AXIS_H
@@ -0,0 +1,55 @@
+#include "BootTimeline.h"
+#include "Trace.h"
+
+static const char* const phase_names[BOOT_PHASE_COUNT] = {
+  "setup", "serial", "radio_mode", "radio_started", "display", "splash", "time",
+  "connected", "ready"
+};
+
+BootTimeline::BootTimeline() {
+  reset();
+}
+
+void BootTimeline::mark(BootPhase phase) {
+  if (phase >= BOOT_PHASE_COUNT) {
+    return;
+  }
+  stamps_us[phase] = micros();
+  reached_mask[phase] = true;
+  tracer.record(TRACE_BOOT, TRACE_INSTANT, phase);
+}
+
+void BootTimeline::reset() {
+  memset(stamps_us, 0, sizeof(stamps_us));
+  memset(reached_mask, 0, sizeof(reached_mask));
+}
+
+bool BootTimeline::reached(BootPhase phase) const {
+  return phase < BOOT_PHASE_COUNT && reached_mask[phase];
+}
+
+uint32_t BootTimeline::getUs(BootPhase phase) const {
+  return reached(phase) ? stamps_us[phase] : 0;
+}
+
+uint32_t BootTimeline::getMs(BootPhase phase) const {
+  return getUs(phase) / 1000;
+}
+
+uint32_t BootTimeline::getReadyMs() const {
+  return getMs(BOOT_READY);
+}
+
+void BootTimeline::report(Print& out) const {
+  out.printf("Boot %s %s:", __DATE__, __TIME__);
+  for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+    if (reached_mask[phase]) {
+      out.printf(" %s=%lu", phase_names[phase], (unsigned long)(stamps_us[phase] / 1000));
+    }
+  }
+  out.println(" ms");
+}
+
+const char* BootTimeline::phaseName(BootPhase phase) {
+  return phase < BOOT_PHASE_COUNT ? phase_names[phase] : "unknown";
+}
@@ -0,0 +1,47 @@
+#ifndef BOOTTIMELINE_H
+#define BOOTTIMELINE_H
+
+#include <Arduino.h>
+
+// Boot phases in the order setup() normally reaches them. Names are printed
+// by report(); append only, the ids also go into trace dumps.
+enum BootPhase : uint8_t {
+  BOOT_SETUP,                  // setup() entered (ROM, bootloader and init before it)
+  BOOT_SERIAL,                 // Serial up
+  BOOT_RADIO_MODE,             // WiFi.mode(WIFI_STA) returned
+  BOOT_RADIO_STARTED,          // Scan or fast connect handed to the network task
+  BOOT_DISPLAY,                // Wire and SSD1306 initialized
+  BOOT_SPLASH,                 // Splash frame handed to the display
+  BOOT_TIME,                   // RTC read
+  BOOT_CONNECTED,              // Station has an IP
+  BOOT_READY,                  // Network settled, application starts
+  BOOT_PHASE_COUNT
+};
+
+// Timestamps of the boot phases, in microseconds since reset. Each mark()
+// also goes to the tracer, and report() prints one line per boot that can be
+// compared across firmware builds.
+class BootTimeline {
+private:
+  uint32_t stamps_us[BOOT_PHASE_COUNT];
+  bool reached_mask[BOOT_PHASE_COUNT];
+
+public:
+  // Constructor
+  BootTimeline();
+
+  void mark(BootPhase phase);
+  void reset();
+
+  // Status methods
+  bool reached(BootPhase phase) const;
+  uint32_t getUs(BootPhase phase) const;        // 0 when not reached
+  uint32_t getMs(BootPhase phase) const;
+  uint32_t getReadyMs() const;                  // Reset to BOOT_READY
+
+  // "Boot <build>: serial=1 radio_mode=32 ... ready=412 ms"
+  void report(Print& out) const;
+  static const char* phaseName(BootPhase phase);
+};
+
+#endif // BOOTTIMELINE_H
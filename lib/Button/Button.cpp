@@ -0,0 +1,87 @@
+#include "Button.h"
+
+Button::Button(uint8_t pin) : pin(pin) {
+  raw_level = HIGH;
+  pressed = false;
+  last_accept = 0;
+  press_time = 0;
+  last_press_time = 0;
+  double_armed = false;
+  long_sent = false;
+}
+
+void Button::begin() {
+  pinMode(pin, INPUT_PULLUP);
+  raw_level = digitalRead(pin);
+  pressed = raw_level == LOW;
+  attachInterruptArg(digitalPinToInterrupt(pin), onEdge, this, CHANGE);
+}
+
+void Button::end() {
+  detachInterrupt(digitalPinToInterrupt(pin));
+}
+
+// Interrupt context: read and timestamp only
+void IRAM_ATTR Button::onEdge(void* arg) {
+  Button* self = (Button*)arg;
+  self->edges.push({(uint8_t)digitalRead(self->pin), (uint32_t)millis()});
+}
+
+void Button::update(unsigned long now) {
+  Edge edge;
+  while (edges.pop(edge)) {
+    raw_level = edge.level;
+    bool down = edge.level == LOW;
+    if (down != pressed && edge.time_ms - last_accept >= BUTTON_DEBOUNCE_MS) {
+      accept(edge.level, edge.time_ms);
+    }
+  }
+
+  // Bounce ended on the other level than the one accepted (or a short tap)
+  bool down = raw_level == LOW;
+  if (down != pressed && now - last_accept >= BUTTON_DEBOUNCE_MS) {
+    accept(raw_level, last_accept + BUTTON_DEBOUNCE_MS);
+  }
+
+  if (pressed && !long_sent && now - press_time >= BUTTON_LONG_PRESS_MS) {
+    long_sent = true;
+    events.push({BUTTON_LONG_PRESS, (uint32_t)(press_time + BUTTON_LONG_PRESS_MS)});
+  }
+}
+
+void Button::accept(uint8_t level, uint32_t time_ms) {
+  last_accept = time_ms;
+  pressed = level == LOW;
+
+  if (!pressed) {
+    events.push({BUTTON_RELEASE, time_ms});
+    if (long_sent) {
+      double_armed = false;  // A long press never starts a double press
+    }
+    return;
+  }
+
+  press_time = time_ms;
+  long_sent = false;
+  events.push({BUTTON_PRESS, time_ms});
+
+  if (double_armed && time_ms - last_press_time <= BUTTON_DOUBLE_PRESS_MS) {
+    events.push({BUTTON_DOUBLE_PRESS, time_ms});
+    double_armed = false;
+  } else {
+    double_armed = true;
+  }
+  last_press_time = time_ms;
+}
+
+bool Button::next(ButtonEvent& event) {
+  return events.pop(event);
+}
+
+bool Button::isPressed() const {
+  return pressed;
+}
+
+uint32_t Button::getDroppedEdges() const {
+  return edges.getDropped();
+}
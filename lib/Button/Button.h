@@ -0,0 +1,68 @@
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include <Arduino.h>
+#include "SpscQueue.h"
+
+#define BUTTON_DEBOUNCE_MS 30        // Edges this close to an accepted one are bounce
+#define BUTTON_LONG_PRESS_MS 800     // Held this long: long press
+#define BUTTON_DOUBLE_PRESS_MS 350   // Second press within this of the first: double press
+
+enum ButtonEventType : uint8_t {
+  BUTTON_PRESS,
+  BUTTON_RELEASE,
+  BUTTON_LONG_PRESS,                 // Once per hold, while still held
+  BUTTON_DOUBLE_PRESS                // Follows the second BUTTON_PRESS
+};
+
+struct ButtonEvent {
+  uint8_t type;
+  uint32_t time_ms;                  // Time of the edge that caused it
+};
+
+// Active-low push button driven by a GPIO interrupt.
+// The ISR only timestamps each edge into a lock-free queue, so taps shorter
+// than any poll interval are still seen. update() debounces in the time
+// domain: the first edge of a burst is accepted at once (no added latency)
+// and the level is settled again once BUTTON_DEBOUNCE_MS has passed.
+class Button {
+private:
+  struct Edge {
+    uint8_t level;
+    uint32_t time_ms;
+  };
+
+  uint8_t pin;
+  SpscQueue<Edge, 16> edges;         // ISR -> update()
+  SpscQueue<ButtonEvent, 8> events;  // update() -> next()
+
+  // Debounced state
+  uint8_t raw_level;                 // Level of the newest edge
+  bool pressed;
+  uint32_t last_accept;
+  uint32_t press_time;
+  uint32_t last_press_time;
+  bool double_armed;                 // Next press may complete a double press
+  bool long_sent;
+
+  static void IRAM_ATTR onEdge(void* arg);
+  void accept(uint8_t level, uint32_t time_ms);
+
+public:
+  // Constructor
+  explicit Button(uint8_t pin);
+
+  // Configure the pin and attach the interrupt
+  void begin();
+  void end();
+
+  // Turn queued edges into events (call from one task only)
+  void update(unsigned long now);
+  bool next(ButtonEvent& event);
+
+  // Status methods
+  bool isPressed() const;
+  uint32_t getDroppedEdges() const;
+};
+
+#endif // BUTTON_H
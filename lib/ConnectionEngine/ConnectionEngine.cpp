@@ -0,0 +1,174 @@
+#include "ConnectionEngine.h"
+#include "Trace.h"
+
+ConnectionEngine::ConnectionEngine() {
+  attempt_active = false;
+  got_ip = false;
+  disconnect_reason = 0;
+  state = CONN_IDLE;
+  start_time = 0;
+  finish_time = 0;
+  timeout_ms = WIFI_TIMEOUT_MS;
+  event_id = 0;
+  events_registered = false;
+  static_ip_set = false;
+}
+
+void ConnectionEngine::begin() {
+  if (events_registered) {
+    return;
+  }
+  event_id = WiFi.onEvent([this](WiFiEvent_t event, WiFiEventInfo_t info) {
+    onWiFiEvent(event, info);
+  });
+  events_registered = true;
+}
+
+void ConnectionEngine::end() {
+  cancel();
+  if (events_registered) {
+    WiFi.removeEvent(event_id);
+    events_registered = false;
+  }
+}
+
+// Runs in the WiFi event task: only record what happened
+void ConnectionEngine::onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+  if (!attempt_active) {
+    return;
+  }
+
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      got_ip = true;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      disconnect_reason = info.wifi_sta_disconnected.reason;
+      break;
+    default:
+      break;
+  }
+}
+
+bool ConnectionEngine::connect(const char* ssid, const char* password, uint32_t timeout,
+                               int32_t channel, const uint8_t* bssid, const StaticIp* static_ip) {
+  begin();
+  if (state == CONN_CONNECTING) {
+    cancel();
+  }
+
+  got_ip = false;
+  disconnect_reason = 0;
+  timeout_ms = timeout;
+  start_time = millis();
+  state = CONN_CONNECTING;
+  attempt_active = true;
+
+  if (static_ip && static_ip->ip) {
+    WiFi.config(IPAddress(static_ip->ip), IPAddress(static_ip->gateway),
+                IPAddress(static_ip->subnet), IPAddress(static_ip->dns));
+    static_ip_set = true;
+  } else if (static_ip_set) {
+    // Back to DHCP
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());
+    static_ip_set = false;
+  }
+
+  tracer.begin(TRACE_CONNECT);
+  WiFi.begin(ssid, (password && *password) ? password : nullptr, channel, bssid);
+  return true;
+}
+
+ConnectionState ConnectionEngine::poll() {
+  if (state != CONN_CONNECTING) {
+    return state;
+  }
+
+  uint8_t reason = disconnect_reason;
+  if (got_ip) {
+    finish(CONN_CONNECTED);
+  } else if (isAuthFailure(reason)) {
+    finish(CONN_AUTH_FAILED);
+  } else if (reason == WIFI_REASON_NO_AP_FOUND) {
+    finish(CONN_NO_AP);
+  } else if (millis() - start_time >= timeout_ms) {
+    finish(CONN_TIMEOUT);
+  }
+
+  return state;
+}
+
+void ConnectionEngine::finish(ConnectionState result) {
+  attempt_active = false;
+  state = result;
+  finish_time = millis();
+  tracer.end(TRACE_CONNECT, result);
+
+  // Stop the driver retrying a connection we have given up on
+  if (result != CONN_CONNECTED) {
+    WiFi.disconnect();
+  }
+}
+
+void ConnectionEngine::cancel() {
+  if (state != CONN_CONNECTING) {
+    return;
+  }
+  attempt_active = false;
+  state = CONN_IDLE;
+  finish_time = millis();
+  tracer.end(TRACE_CONNECT, CONN_IDLE);
+  WiFi.disconnect();
+}
+
+ConnectionState ConnectionEngine::getState() const {
+  return state;
+}
+
+bool ConnectionEngine::isConnecting() const {
+  return state == CONN_CONNECTING;
+}
+
+uint8_t ConnectionEngine::getDisconnectReason() const {
+  return disconnect_reason;
+}
+
+unsigned long ConnectionEngine::getElapsedMs() const {
+  if (state == CONN_CONNECTING) {
+    return millis() - start_time;
+  }
+  return finish_time - start_time;
+}
+
+// Reasons the driver reports when the handshake rejects the passphrase.
+// AUTH_EXPIRE and HANDSHAKE_TIMEOUT are often transient and retried by the
+// driver, so those attempts run on to the timeout instead
+bool ConnectionEngine::isAuthFailure(uint8_t reason) {
+  switch (reason) {
+    case WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT:
+    case WIFI_REASON_AUTH_FAIL:
+    case WIFI_REASON_MIC_FAILURE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+const char* ConnectionEngine::stateToString(ConnectionState state) {
+  switch (state) {
+    case CONN_IDLE:
+      return "Idle";
+    case CONN_CONNECTING:
+      return "Connecting";
+    case CONN_CONNECTED:
+      return "Connected";
+    case CONN_AUTH_FAILED:
+      return "Wrong password";
+    case CONN_NO_AP:
+      return "Network not found";
+    case CONN_TIMEOUT:
+      return "Timed out";
+    default:
+      return "Unknown";
+  }
+}
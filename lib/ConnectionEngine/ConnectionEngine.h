@@ -0,0 +1,73 @@
+#ifndef CONNECTIONENGINE_H
+#define CONNECTIONENGINE_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "configs.h"
+
+enum ConnectionState {
+  CONN_IDLE,
+  CONN_CONNECTING,
+  CONN_CONNECTED,              // Station has an IP
+  CONN_AUTH_FAILED,            // Password rejected
+  CONN_NO_AP,                  // Network (or cached BSSID/channel) not found
+  CONN_TIMEOUT
+};
+
+// Addresses from an earlier DHCP lease; connecting with them skips DHCP
+struct StaticIp {
+  uint32_t ip;                 // 0 = use DHCP
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+};
+
+// Station connection driven by WiFi events instead of status() polling.
+// connect() starts an attempt and returns at once; poll() reports progress
+// without blocking. The attempt completes on the got-IP event and fails as
+// soon as the driver reports a wrong password or a missing AP, so only
+// genuinely slow links wait for the timeout.
+class ConnectionEngine {
+private:
+  // Written from the WiFi event task, read by poll()
+  volatile bool attempt_active;
+  volatile bool got_ip;
+  volatile uint8_t disconnect_reason;   // Last reason seen during the attempt
+
+  ConnectionState state;
+  unsigned long start_time;
+  unsigned long finish_time;
+  uint32_t timeout_ms;
+  wifi_event_id_t event_id;
+  bool events_registered;
+  bool static_ip_set;          // Station configured with a static address
+
+  void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info);
+  void finish(ConnectionState result);
+
+public:
+  // Constructor
+  ConnectionEngine();
+
+  // Register the event handler (connect() does this on first use)
+  void begin();
+  void end();
+
+  // Start connecting; channel and BSSID skip the driver's own scan, a
+  // static address skips DHCP
+  bool connect(const char* ssid, const char* password = nullptr, uint32_t timeout = WIFI_TIMEOUT_MS,
+               int32_t channel = 0, const uint8_t* bssid = nullptr, const StaticIp* static_ip = nullptr);
+  ConnectionState poll();
+  void cancel();
+
+  // Status methods
+  ConnectionState getState() const;
+  bool isConnecting() const;
+  uint8_t getDisconnectReason() const;
+  unsigned long getElapsedMs() const;   // Attempt duration so far, or total once finished
+
+  static bool isAuthFailure(uint8_t reason);
+  static const char* stateToString(ConnectionState state);
+};
+
+#endif // CONNECTIONENGINE_H
@@ -0,0 +1,313 @@
+#include "CredentialStore.h"
+#include <stddef.h>
+
+// Scoring weights. Signal strength dominates; history breaks ties between
+// networks of similar strength and failures push a network down the list.
+#define SCORE_SUCCESS_WEIGHT 4       // Per success, capped
+#define SCORE_SUCCESS_CAP 10
+#define SCORE_RECENT_BONUS 15        // Network of the last successful boot
+#define SCORE_FAIL_PENALTY 20        // Per failure since the last success
+
+// ========================================
+// ScanSet
+// ========================================
+
+ScanSet::ScanSet() {
+  clear();
+}
+
+void ScanSet::clear() {
+  memset(slots, 0, sizeof(slots));
+  used = 0;
+}
+
+// FNV-1a; 0 marks an empty slot
+uint32_t ScanSet::hashOf(const char* ssid) {
+  uint32_t hash = 2166136261u;
+  while (*ssid) {
+    hash ^= (uint8_t)*ssid++;
+    hash *= 16777619u;
+  }
+  return hash ? hash : 1;
+}
+
+bool ScanSet::add(const char* ssid, int32_t rssi, int16_t index) {
+  if (!ssid || !*ssid) {
+    return false;  // Hidden networks cannot match a saved SSID
+  }
+
+  uint32_t hash = hashOf(ssid);
+  uint8_t slot = hash & (SCAN_SET_SLOTS - 1);
+
+  while (slots[slot].hash) {
+    if (slots[slot].hash == hash && strcmp(slots[slot].ssid, ssid) == 0) {
+      if (rssi > slots[slot].rssi) {
+        slots[slot].rssi = rssi;
+        slots[slot].index = index;
+      }
+      return true;
+    }
+    slot = (slot + 1) & (SCAN_SET_SLOTS - 1);
+  }
+
+  if (used >= SCAN_SET_MAX) {
+    return false;
+  }
+
+  slots[slot].hash = hash;
+  slots[slot].ssid = ssid;
+  slots[slot].index = index;
+  slots[slot].rssi = constrain(rssi, -128, 0);
+  used++;
+  return true;
+}
+
+int16_t ScanSet::find(const char* ssid, int8_t* rssi) const {
+  uint32_t hash = hashOf(ssid);
+  uint8_t slot = hash & (SCAN_SET_SLOTS - 1);
+
+  while (slots[slot].hash) {
+    if (slots[slot].hash == hash && strcmp(slots[slot].ssid, ssid) == 0) {
+      if (rssi) *rssi = slots[slot].rssi;
+      return slots[slot].index;
+    }
+    slot = (slot + 1) & (SCAN_SET_SLOTS - 1);
+  }
+  return -1;
+}
+
+uint8_t ScanSet::size() const {
+  return used;
+}
+
+// ========================================
+// CredentialStore
+// ========================================
+
+CredentialStore::CredentialStore(Preferences* pref, const String& namespace_name) {
+  preferences = pref;
+  pref_namespace = namespace_name;
+  loaded = false;
+  memset(&blob, 0, sizeof(blob));
+}
+
+bool CredentialStore::load() {
+  if (loaded) {
+    return true;
+  }
+
+  // Read-only begin() fails until the namespace exists: nothing saved yet
+  loaded = true;
+  size_t length = 0;
+  if (preferences->begin(pref_namespace.c_str(), true)) {
+    length = preferences->getBytes(CRED_STORE_KEY, &blob, sizeof(blob));
+    preferences->end();
+  }
+
+  size_t header = offsetof(Blob, records);
+  if (length >= header && blob.version == CRED_STORE_VERSION &&
+      blob.record_size == sizeof(SavedNetwork) && blob.count <= CRED_STORE_MAX &&
+      length == header + blob.count * sizeof(SavedNetwork)) {
+    return true;
+  }
+
+  if (length > 0) {
+    Serial.println("Credential store has an unknown layout, starting empty");
+  }
+  memset(&blob, 0, sizeof(blob));
+  blob.version = CRED_STORE_VERSION;
+  blob.record_size = sizeof(SavedNetwork);
+
+  if (length == 0 && migrateLegacy()) {
+    save();
+  }
+  return true;
+}
+
+// Single ssid/password keys written by earlier firmware
+bool CredentialStore::migrateLegacy() {
+  if (!preferences->begin(pref_namespace.c_str(), false)) {
+    return false;
+  }
+
+  String ssid = preferences->getString("ssid", "");
+  if (ssid.length() == 0 || ssid.length() >= sizeof(SavedNetwork::ssid)) {
+    preferences->end();
+    return false;
+  }
+
+  SavedNetwork& record = blob.records[0];
+  strncpy(record.ssid, ssid.c_str(), sizeof(record.ssid) - 1);
+  String password = preferences->getString("password", "");
+  strncpy(record.password, password.c_str(), sizeof(record.password) - 1);
+  if (preferences->getBytes("bssid", record.bssid, sizeof(record.bssid)) == sizeof(record.bssid)) {
+    record.channel = preferences->getUChar("channel", 0);
+  }
+  record.success_count = 1;
+  record.last_rssi = -100;
+  record.last_used = blob.sequence = 1;
+  blob.count = 1;
+
+  preferences->remove("ssid");
+  preferences->remove("password");
+  preferences->remove("bssid");
+  preferences->remove("channel");
+  preferences->end();
+
+  Serial.println("Migrated saved network: " + ssid);
+  return true;
+}
+
+bool CredentialStore::save() {
+  if (!preferences->begin(pref_namespace.c_str(), false)) {
+    Serial.println("Failed to open preferences for writing");
+    return false;
+  }
+
+  size_t length = offsetof(Blob, records) + blob.count * sizeof(SavedNetwork);
+  bool ok = preferences->putBytes(CRED_STORE_KEY, &blob, length) == length;
+  preferences->end();
+  return ok;
+}
+
+void CredentialStore::clear() {
+  load();
+  blob.count = 0;
+  blob.sequence = 0;
+  save();
+}
+
+uint8_t CredentialStore::count() {
+  load();
+  return blob.count;
+}
+
+const SavedNetwork* CredentialStore::get(uint8_t index) {
+  load();
+  return index < blob.count ? &blob.records[index] : nullptr;
+}
+
+int CredentialStore::find(const char* ssid) {
+  load();
+  for (uint8_t i = 0; i < blob.count; i++) {
+    if (strcmp(blob.records[i].ssid, ssid) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+const SavedNetwork* CredentialStore::mostRecent() {
+  load();
+  const SavedNetwork* best = nullptr;
+  for (uint8_t i = 0; i < blob.count; i++) {
+    if (!best || blob.records[i].last_used > best->last_used) {
+      best = &blob.records[i];
+    }
+  }
+  return best;
+}
+
+int16_t CredentialStore::score(const SavedNetwork& record, int8_t rssi) const {
+  int16_t value = rssi;
+  value += min((int)record.success_count, SCORE_SUCCESS_CAP) * SCORE_SUCCESS_WEIGHT;
+  if (record.last_used == blob.sequence && blob.sequence > 0) {
+    value += SCORE_RECENT_BONUS;
+  }
+  value -= record.fail_count * SCORE_FAIL_PENALTY;
+  return value;
+}
+
+uint8_t CredentialStore::rank(const ScanSet& scan, Candidate* out, uint8_t max_out) {
+  load();
+  uint8_t found = 0;
+
+  for (uint8_t i = 0; i < blob.count && found < max_out; i++) {
+    int8_t rssi;
+    int16_t network = scan.find(blob.records[i].ssid, &rssi);
+    if (network < 0) {
+      continue;
+    }
+
+    Candidate candidate = {i, network, score(blob.records[i], rssi)};
+
+    // Insertion sort; the list is at most CRED_STORE_MAX long
+    uint8_t pos = found++;
+    while (pos > 0 && out[pos - 1].score < candidate.score) {
+      out[pos] = out[pos - 1];
+      pos--;
+    }
+    out[pos] = candidate;
+  }
+  return found;
+}
+
+// Least recently used record, replaced when the store is full
+uint8_t CredentialStore::evictionSlot() const {
+  uint8_t oldest = 0;
+  for (uint8_t i = 1; i < blob.count; i++) {
+    if (blob.records[i].last_used < blob.records[oldest].last_used) {
+      oldest = i;
+    }
+  }
+  return oldest;
+}
+
+void CredentialStore::recordSuccess(const char* ssid, const char* password, const uint8_t* bssid,
+                                    uint8_t channel, int32_t rssi) {
+  if (strlen(ssid) >= sizeof(SavedNetwork::ssid)) {
+    return;
+  }
+
+  int index = find(ssid);
+  if (index < 0) {
+    if (blob.count < CRED_STORE_MAX) {
+      index = blob.count++;
+    } else {
+      index = evictionSlot();
+      Serial.printf("Forgetting network: %s\n", blob.records[index].ssid);
+    }
+    memset(&blob.records[index], 0, sizeof(SavedNetwork));
+    strncpy(blob.records[index].ssid, ssid, sizeof(SavedNetwork::ssid) - 1);
+  }
+
+  // password may point into this record
+  SavedNetwork& record = blob.records[index];
+  char new_password[sizeof(record.password)] = {0};
+  strncpy(new_password, password ? password : "", sizeof(new_password) - 1);
+  memcpy(record.password, new_password, sizeof(record.password));
+  if (bssid && channel) {
+    memcpy(record.bssid, bssid, sizeof(record.bssid));
+    record.channel = channel;
+  }
+  record.last_rssi = constrain(rssi, -128, 0);
+  if (record.success_count < 0xFFFF) {
+    record.success_count++;
+  }
+  record.fail_count = 0;
+  record.last_used = ++blob.sequence;
+  save();
+}
+
+void CredentialStore::recordFailure(const char* ssid) {
+  int index = find(ssid);
+  if (index < 0) {
+    return;
+  }
+
+  SavedNetwork& record = blob.records[index];
+  if (record.fail_count < 0xFF) {
+    record.fail_count++;
+  }
+  save();
+}
+
+void CredentialStore::clearHint(const char* ssid) {
+  int index = find(ssid);
+  if (index < 0 || blob.records[index].channel == 0) {
+    return;
+  }
+
+  blob.records[index].channel = 0;
+  save();
+}
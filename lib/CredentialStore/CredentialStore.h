@@ -0,0 +1,107 @@
+#ifndef CREDENTIALSTORE_H
+#define CREDENTIALSTORE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#define CRED_STORE_VERSION 1
+#define CRED_STORE_MAX 8             // Networks remembered
+#define CRED_STORE_KEY "networks"    // Preferences key of the blob
+#define SCAN_SET_SLOTS 128           // Hash slots (power of two)
+#define SCAN_SET_MAX 96              // Entries accepted before the set is full
+
+// One remembered network. Fixed size so the whole store is a single blob.
+struct SavedNetwork {
+  char ssid[33];
+  char password[64];
+  uint8_t bssid[6];            // Last access point used
+  uint8_t channel;             // Its primary channel (0 = unknown)
+  int8_t last_rssi;            // Signal when last seen
+  uint16_t success_count;
+  uint8_t fail_count;          // Failures since the last success
+  uint8_t reserved;
+  uint32_t last_used;          // Store sequence number of the last success
+};
+
+// SSIDs from one scan, hashed for constant-time lookup. Duplicate SSIDs
+// (several APs of one network) keep the strongest signal. The strings are
+// not copied and must outlive the set.
+class ScanSet {
+private:
+  struct Slot {
+    uint32_t hash;             // 0 = empty
+    const char* ssid;
+    int16_t index;             // Caller's index of the strongest entry
+    int8_t rssi;
+  };
+  Slot slots[SCAN_SET_SLOTS];
+  uint8_t used;
+
+  static uint32_t hashOf(const char* ssid);
+
+public:
+  ScanSet();
+  void clear();
+  bool add(const char* ssid, int32_t rssi, int16_t index);
+  // Index passed to add() for this SSID, or -1. rssi is set on a hit.
+  int16_t find(const char* ssid, int8_t* rssi = nullptr) const;
+  uint8_t size() const;
+};
+
+// Saved network that is in range, ordered by score
+struct Candidate {
+  uint8_t record;              // Index into the store
+  int16_t network;             // Index passed to ScanSet::add()
+  int16_t score;
+};
+
+// Remembered networks kept as one versioned blob in Preferences. load() is a
+// single NVS read; every change is written back with a single putBytes().
+// Networks saved by the old single-network keys are migrated on first load.
+class CredentialStore {
+private:
+  struct Blob {
+    uint8_t version;
+    uint8_t count;
+    uint8_t record_size;
+    uint8_t reserved;
+    uint32_t sequence;         // Incremented on every success
+    SavedNetwork records[CRED_STORE_MAX];
+  };
+
+  Preferences* preferences;
+  String pref_namespace;
+  Blob blob;
+  bool loaded;
+
+  bool migrateLegacy();
+  int16_t score(const SavedNetwork& record, int8_t rssi) const;
+  uint8_t evictionSlot() const;
+
+public:
+  // Constructor
+  CredentialStore(Preferences* pref, const String& namespace_name = "wifi-creds");
+
+  // Storage
+  bool load();                 // No-op once loaded
+  bool save();
+  void clear();
+
+  // Records
+  uint8_t count();
+  const SavedNetwork* get(uint8_t index);
+  int find(const char* ssid);
+  const SavedNetwork* mostRecent();
+
+  // Rank saved networks present in a scan, best first. Returns how many.
+  uint8_t rank(const ScanSet& scan, Candidate* out, uint8_t max_out);
+
+  // Update after a connection attempt (both write the blob)
+  void recordSuccess(const char* ssid, const char* password, const uint8_t* bssid,
+                     uint8_t channel, int32_t rssi);
+  void recordFailure(const char* ssid);
+  // Forget the cached BSSID/channel but keep the credentials
+  void clearHint(const char* ssid);
+};
+
+#endif // CREDENTIALSTORE_H
@@ -0,0 +1,23 @@
+#ifndef FONT5X7_H
+#define FONT5X7_H
+
+#include <Arduino.h>
+
+// Classic 5x7 font with one byte per column, LSB at the top. This is the
+// same layout as an SSD1306 page, so a glyph column can be written straight
+// into the framebuffer.
+#define FONT5X7_FIRST 0x20     // First glyph (space)
+#define FONT5X7_GLYPHS 95      // Printable ASCII
+#define FONT5X7_WIDTH 5        // Glyph columns
+#define FONT5X7_ADVANCE 6      // Glyph columns plus spacing
+#define FONT5X7_HEIGHT 8
+
+extern const uint8_t font5x7[FONT5X7_GLYPHS][FONT5X7_WIDTH] PROGMEM;
+
+// Column data for a character. Bytes outside printable ASCII come back
+// blank: control codes, DEL and the upper half that Adafruit GFX draws as
+// cp437 glyphs. Each byte of a UTF-8 SSID like "Caf\xC3\xA9" is therefore
+// an empty cell of normal width, where GFX print() showed two cp437 glyphs.
+const uint8_t* font5x7_glyph(char c);
+
+#endif // FONT5X7_H
@@ -3,29 +3,55 @@
 #include <Adafruit_SSD1306.h>
 #include <Adafruit_GFX.h>
 #include "KeyInput.h"
+#include "KeyLayout.h"
+#include "Axis.h"
+#include "Button.h"
+#include "PartialDisplay.h"
+#include "SpscQueue.h"
+#include "TaskRuntime.h"
+#include "Trace.h"
 #include "configs.h"
 
 // Global display object
-extern Adafruit_SSD1306 display;
+extern PartialDisplay display;
 
-// Static password buffer
-static char password_buffer[50] = "";
+// Buffer behind prompt_keyboard(); room for a full WPA passphrase
+static char password_buffer[KEYINPUT_MAX_LENGTH + 1] = "";
 
-// Movement timing variables
-static unsigned long last_move_time = 0;
+// Text line above the key grid
+#define TEXT_LINE_Y 8
+#define TEXT_LINE_CHARS 19  // After the "> " prompt
 
-const char keyMap[6][18] = {
-    {REMOVE_CHAR, LEFT_CHAR, RIGHT_CHAR, 'A','B','C','D','E','F','G','H','I','J','K','L','M','N','O'},
-    {'P','Q','R','S','T','U','V','W','X','Y','Z','a','b','c','d','e','f','g'},
-    {'h','i','j','k','l','m','n','o','p','q','r','s','t','u','v','w','x','y'},
-    {'z','0','1','2','3','4','5','6','7','8','9','!','?','@','#','$','%','^'},
-    {'&','*','(',')','-','_','+','=','|','\\',':',';','"','\'','<','>',',','.'},
-    {'/','~','`','[',']','{','}',SPACE_CHAR,' ',' ',' ',' ',' ',' ',' ',' ',' ',' '}
-};
+// Layout used by prompt_keyboard() and draw_keyboard()
+static const KeyGrid* layout = &FREQUENCY_KEYS;
+
+// What the panel currently shows, so a redraw paints only what changed
+static bool keyboard_drawn = false;
+static uint8_t drawn_page = 0;
+static uint8_t drawn_x = 0;
+static uint8_t drawn_y = 0;
+static char drawn_text[TEXT_LINE_CHARS + 1] = "";
+
+// Events from sample_controls() to the screens, oldest first
+static SpscQueue<InputEvent, 32> input_events;
+
+// Pot filtering and auto-repeat; only the input task touches these
+static Axis x_axis(POT_X_PIN);
+static Axis y_axis(POT_Y_PIN);
+static Button select_button(BTN_SELECT);
+
+// Button events in ButtonEventType order
+static const uint8_t button_events[] = {NAV_SELECT, NAV_RELEASE, NAV_LONG_PRESS, NAV_DOUBLE_PRESS};
 
 // Initialize potentiometers and button
 void init_controls() {
-    pinMode(BTN_SELECT, INPUT_PULLUP);
+    static bool initialized = false;
+    if(initialized) {
+        return;  // Screens call this too; the input task already owns the pins
+    }
+    initialized = true;
+    
+    select_button.begin();
     
     // Set ADC resolution to 12 bits (0-4095)
     analogReadResolution(12);
@@ -35,253 +61,284 @@ void init_controls() {
     analogSetPinAttenuation(POT_Y_PIN, ADC_11db);
 }
 
-// Read horizontal potentiometer and return movement (-1, 0, 1)
-int get_x_movement() {
-    static int last_zone = 1;  // 0=left, 1=neutral, 2=right
-    static unsigned long last_zone_time = 0;
+// Sample every control once; runs in the input task
+void sample_controls() {
+    uint32_t now = millis();
     
-    int pot_value = analogRead(POT_X_PIN);
-    int current_zone;
+    x_axis.sample();
+    y_axis.sample();
     
-    // Define zones with hysteresis to prevent jitter
-    if(pot_value < 1200) {          // 0-29% = LEFT zone
-        current_zone = 0;
-    } else if(pot_value > 2895) {   // 71-100% = RIGHT zone  
-        current_zone = 2;
-    } else {                        // 29-71% = NEUTRAL zone
-        current_zone = 1;
+    int x_move = x_axis.update(now);
+    if(x_move != 0) {
+        input_events.push({(uint8_t)(x_move < 0 ? NAV_LEFT : NAV_RIGHT), now});
     }
     
-    // Only register movement when entering a new zone
-    if(current_zone != last_zone) {
-        unsigned long current_time = millis();
-        
-        // Rate limiting: minimum 150ms between zone changes
-        if(current_time - last_zone_time > 150) {
-            last_zone_time = current_time;
-            
-            int movement = 0;
-            if(last_zone == 1 && current_zone == 0) {
-                movement = -1;  // Neutral → Left = move left
-            } else if(last_zone == 1 && current_zone == 2) {
-                movement = 1;   // Neutral → Right = move right
-            } else if(last_zone == 0 && current_zone == 2) {
-                movement = 1;   // Left → Right = move right
-            } else if(last_zone == 2 && current_zone == 0) {
-                movement = -1;  // Right → Left = move left
-            }
-            
-            last_zone = current_zone;
-            return movement;
-        }
+    int y_move = y_axis.update(now);
+    if(y_move != 0) {
+        input_events.push({(uint8_t)(y_move < 0 ? NAV_UP : NAV_DOWN), now});
     }
     
-    return 0;  // No movement
+    // Edges were timestamped by the button ISR; keep those times
+    select_button.update(now);
+    ButtonEvent press;
+    while(select_button.next(press)) {
+        input_events.push({button_events[press.type], press.time_ms});
+    }
 }
 
-// Read vertical potentiometer and return movement (-1, 0, 1)
-int get_y_movement() {
-    static int last_zone = 1;  // 0=up, 1=neutral, 2=down
-    static unsigned long last_zone_time = 0;
-    
-    int pot_value = analogRead(POT_Y_PIN);
-    int current_zone;
-    
-    // Define zones with hysteresis
-    if(pot_value < 1200) {          // 0-29% = UP zone
-        current_zone = 0;
-    } else if(pot_value > 2895) {   // 71-100% = DOWN zone
-        current_zone = 2;
-    } else {                        // 29-71% = NEUTRAL zone
-        current_zone = 1;
-    }
-    
-    // Only register movement when entering a new zone
-    if(current_zone != last_zone) {
-        unsigned long current_time = millis();
-        
-        if(current_time - last_zone_time > 150) {
-            last_zone_time = current_time;
-            
-            int movement = 0;
-            if(last_zone == 1 && current_zone == 0) {
-                movement = -1;  // Neutral → Up = move up
-            } else if(last_zone == 1 && current_zone == 2) {
-                movement = 1;   // Neutral → Down = move down
-            } else if(last_zone == 0 && current_zone == 2) {
-                movement = 1;   // Up → Down = move down
-            } else if(last_zone == 2 && current_zone == 0) {
-                movement = -1;  // Down → Up = move up
-            }
-            
-            last_zone = current_zone;
-            return movement;
-        }
+bool next_input(InputEvent& event) {
+    if(!input_events.pop(event)) {
+        return false;
     }
-    
-    return 0;  // No movement
+    runtime.recordInputLatency(millis() - event.time_ms);
+    return true;
 }
 
-// Button debouncing for select button
-bool select_button_pressed() {
-    static unsigned long last_press_time = 0;
-    
-    if(digitalRead(BTN_SELECT) == LOW) {
-        unsigned long current_time = millis();
-        if(current_time - last_press_time > 200) { // 200ms debounce
-            last_press_time = current_time;
-            return true;
-        }
-    }
-    return false;
+void flush_input() {
+    input_events.clear();
 }
 
-// Check if enough time has passed for movement
-bool can_move() {
-    unsigned long current_time = millis();
-    if(current_time - last_move_time > MOVE_DELAY) {
-        last_move_time = current_time;
-        return true;
-    }
-    return false;
+void set_keyboard_layout(const KeyGrid& keys) {
+    layout = &keys;
+    keyboard_drawn = false;
+}
+
+const KeyGrid& get_keyboard_layout() {
+    return *layout;
 }
 
-// Draw the keyboard interface
-void draw_keyboard(uint8_t cursor_x, uint8_t cursor_y, const char* current_text) {
-    display.clearDisplay();
+// Cells tile the grid without overlapping, so one can be repainted alone
+static void draw_key(uint8_t page, uint8_t col, uint8_t row, bool highlighted) {
+    uint16_t bg = highlighted ? SSD1306_WHITE : SSD1306_BLACK;
+    uint16_t fg = highlighted ? SSD1306_BLACK : SSD1306_WHITE;
     
-    // Draw title
-    display.setTextSize(1);
+    display.fillRect(layout->cell_x[col], layout->cell_y[row], layout->pitch_x, KEY_PITCH_Y, bg);
+    display.drawChar(layout->glyph_x[col], layout->cell_y[row], layout->label(page, row, col), fg, bg, 1, 1);
+}
+
+// The "> text" line shows the tail of the input when it is too long
+static void draw_text_line(const char* visible) {
+    display.fillRect(0, TEXT_LINE_Y, SCREEN_WIDTH, 8, SSD1306_BLACK);
     display.setTextColor(SSD1306_WHITE);
-    display.setCursor(0, 0);
-    display.println("Enter Password:");
-    
-    // Draw current input text (line 2)
-    display.setCursor(0, 10);
+    display.setCursor(0, TEXT_LINE_Y);
     display.print("> ");
-    display.println(current_text);
+    display.print(visible);
+}
+
+void invalidate_keyboard() {
+    keyboard_drawn = false;
+}
+
+// Draw the keyboard interface; after the first frame only changes are painted
+void draw_keyboard(uint8_t cursor_x, uint8_t cursor_y, const char* current_text, uint8_t page) {
+    TRACE_SCOPE(TRACE_KEYBOARD);
+    size_t len = strlen(current_text);
+    const char* visible = current_text + (len > TEXT_LINE_CHARS ? len - TEXT_LINE_CHARS : 0);
     
-    // Draw keyboard starting from line 3 (y=20)
-    for(int row = 0; row < 6; row++) {
-        for(int col = 0; col < 18; col++) {
-            int x = col * 7;  // 7 pixels per character
-            int y = 20 + (row * 8);  // 8 pixels per row, starting at y=20
-            
-            // Skip if position would be off screen
-            if(x >= SCREEN_WIDTH - 6) break;
-            if(y >= SCREEN_HEIGHT - 8) break;
-            
-            char ch = keyMap[row][col];
-            if(ch == 0 || ch == SPACE_CHAR) {
-                if(ch == SPACE_CHAR) ch = '_';  // Show space as underscore
-                else continue;
-            }
-            
-            // Highlight cursor position
-            if(row == cursor_y && col == cursor_x) {
-                display.fillRect(x-1, y-1, 8, 10, SSD1306_WHITE);
-                display.setTextColor(SSD1306_BLACK);
-            } else {
-                display.setTextColor(SSD1306_WHITE);
-            }
-            
-            display.setCursor(x, y);
-            
-            // Handle special characters
-            if(ch == REMOVE_CHAR) {
-                display.print("DEL");
-            } else if(ch == LEFT_CHAR) {
-                display.print("<");
-            } else if(ch == RIGHT_CHAR) {
-                display.print(">");
-            } else {
-                display.print(ch);
+    if(!keyboard_drawn || page != drawn_page) {
+        display.clearDisplay();
+        
+        // Draw title
+        display.setTextSize(1);
+        display.setTextColor(SSD1306_WHITE);
+        display.setCursor(0, 0);
+        display.print("Enter Password:");
+        
+        draw_text_line(visible);
+        
+        for(uint8_t row = 0; row < layout->rows; row++) {
+            for(uint8_t col = 0; col < layout->cols; col++) {
+                draw_key(page, col, row, row == cursor_y && col == cursor_x);
             }
         }
+        
+        display.display();
+        keyboard_drawn = true;
+    } else {
+        // Flush the bounding box of everything repainted in one pass; the
+        // diff inside it still skips clean columns
+        int16_t x0 = SCREEN_WIDTH, y0 = SCREEN_HEIGHT, x1 = -1, y1 = -1;
+        
+        if(cursor_x != drawn_x || cursor_y != drawn_y) {
+            draw_key(page, drawn_x, drawn_y, false);
+            draw_key(page, cursor_x, cursor_y, true);
+            x0 = layout->cell_x[min(drawn_x, cursor_x)];
+            x1 = layout->cell_x[max(drawn_x, cursor_x)] + layout->pitch_x - 1;
+            y0 = layout->cell_y[min(drawn_y, cursor_y)];
+            y1 = layout->cell_y[max(drawn_y, cursor_y)] + KEY_PITCH_Y - 1;
+        }
+        
+        if(strcmp(visible, drawn_text) != 0) {
+            draw_text_line(visible);
+            x0 = 0;
+            x1 = SCREEN_WIDTH - 1;
+            y0 = min(y0, (int16_t)TEXT_LINE_Y);
+            y1 = max(y1, (int16_t)(TEXT_LINE_Y + 7));
+        }
+        
+        if(x1 >= 0) {
+            display.displayRect(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+        }
     }
     
-    // Draw instructions at bottom
-    display.setTextColor(SSD1306_WHITE);
-    display.setCursor(0, 56);
-    display.print("Move:Pots Sel:Button");
-    
-    display.display();
+    drawn_page = page;
+    drawn_x = cursor_x;
+    drawn_y = cursor_y;
+    strncpy(drawn_text, visible, TEXT_LINE_CHARS);
+    drawn_text[TEXT_LINE_CHARS] = '\0';
 }
 
-const char* prompt_keyboard() {
+// ========================================
+// KeyInput: keyboard as a pollable state machine
+// ========================================
+
+KeyInput::KeyInput(char* buffer, size_t size) {
+    this->buffer = buffer;
+    capacity = size > 0 ? size - 1 : 0;
+    keys = layout;
+    state = KEYINPUT_IDLE;
+    length = 0;
+    page = 0;
+    cursor_x = 0;
+    cursor_y = 0;
+    undo_pos = 0;
+    undo_char = 0;
+    dirty = false;
+    if(size > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+void KeyInput::begin() {
     init_controls();
     
-    // Clear password buffer
-    memset(password_buffer, 0, sizeof(password_buffer));
-    uint8_t text_pos = 0;
-    uint8_t cursor_x = 3;  // Start at 'A'
-    uint8_t cursor_y = 0;
+    keys = layout;
+    length = 0;
+    buffer[0] = '\0';
+    page = 0;
+    cursor_x = keys->home_col;
+    cursor_y = keys->home_row;
+    undo_pos = 0;
+    undo_char = 0;
+    state = KEYINPUT_ACTIVE;
     
     // Show initial keyboard
-    draw_keyboard(cursor_x, cursor_y, password_buffer);
+    flush_input();
+    invalidate_keyboard();
+    draw_keyboard(cursor_x, cursor_y, buffer, page);
+    dirty = false;
+}
+
+bool KeyInput::poll() {
+    if(state != KEYINPUT_ACTIVE) {
+        return state == KEYINPUT_DONE;
+    }
     
-    while(true) {
-        // Handle potentiometer movement
-        if(can_move()) {
-            int x_move = get_x_movement();
-            int y_move = get_y_movement();
-            
-            if(x_move != 0 || y_move != 0) {
-                // Update cursor position
-                if(x_move == -1) {
-                    cursor_x = (cursor_x == 0) ? 17 : cursor_x - 1;  // Wrap to right
-                } else if(x_move == 1) {
-                    cursor_x = (cursor_x == 17) ? 0 : cursor_x + 1;  // Wrap to left
-                }
-                
-                if(y_move == -1) {
-                    cursor_y = (cursor_y == 0) ? 5 : cursor_y - 1;   // Wrap to bottom
-                } else if(y_move == 1) {
-                    cursor_y = (cursor_y == 5) ? 0 : cursor_y + 1;   // Wrap to top
-                }
-                
-                // Redraw keyboard with new cursor position
-                draw_keyboard(cursor_x, cursor_y, password_buffer);
-            }
-        }
-        
-        // Handle button press
-        if(select_button_pressed()) {
-            char selected_char = keyMap[cursor_y][cursor_x];
-            
-            if(selected_char == REMOVE_CHAR) {
-                // Delete last character
-                if(text_pos > 0) {
-                    text_pos--;
-                    password_buffer[text_pos] = '\0';
-                }
-            } else if(selected_char == LEFT_CHAR) {
-                // Special case: finish input (like BACK button)
-                break;
-            } else if(selected_char == RIGHT_CHAR) {
-                // Special case: add space
-                if(text_pos < 49) {
-                    password_buffer[text_pos] = ' ';
-                    text_pos++;
-                    password_buffer[text_pos] = '\0';
-                }
-            } else if(selected_char != 0 && text_pos < 49) {
-                // Add character to password
-                if(selected_char == SPACE_CHAR) {
-                    password_buffer[text_pos] = ' ';
-                } else {
-                    password_buffer[text_pos] = selected_char;
-                }
-                text_pos++;
-                password_buffer[text_pos] = '\0';
+    InputEvent event;
+    while(state == KEYINPUT_ACTIVE && next_input(event)) {
+        handle(event);
+    }
+    
+    // Redraw with new cursor position or updated text
+    if(dirty && state == KEYINPUT_ACTIVE) {
+        draw_keyboard(cursor_x, cursor_y, buffer, page);
+    }
+    dirty = false;
+    
+    return state == KEYINPUT_DONE;
+}
+
+void KeyInput::cancel() {
+    state = KEYINPUT_IDLE;
+}
+
+void KeyInput::handle(const InputEvent& event) {
+    // Update cursor position
+    switch(event.type) {
+        case NAV_LEFT:
+            cursor_x = (cursor_x == 0) ? keys->cols - 1 : cursor_x - 1;  // Wrap to right
+            dirty = true;
+            return;
+        case NAV_RIGHT:
+            cursor_x = (cursor_x == keys->cols - 1) ? 0 : cursor_x + 1;  // Wrap to left
+            dirty = true;
+            return;
+        case NAV_UP:
+            cursor_y = (cursor_y == 0) ? keys->rows - 1 : cursor_y - 1;  // Wrap to bottom
+            dirty = true;
+            return;
+        case NAV_DOWN:
+            cursor_y = (cursor_y == keys->rows - 1) ? 0 : cursor_y + 1;  // Wrap to top
+            dirty = true;
+            return;
+        case NAV_LONG_PRESS:
+            // Long press confirms the text as typed before it
+            length = undo_pos;
+            if(length > 0) {
+                buffer[length - 1] = undo_char;
             }
-            
-            // Redraw with updated text
-            draw_keyboard(cursor_x, cursor_y, password_buffer);
+            buffer[length] = '\0';
+            state = KEYINPUT_DONE;
+            return;
+        case NAV_SELECT:
+            break;
+        default:
+            return;  // Release and double press are not used here
+    }
+    
+    // Handle button press
+    undo_pos = length;
+    undo_char = length > 0 ? buffer[length - 1] : 0;
+    dirty = true;
+    
+    uint8_t selected = keys->key(page, cursor_y, cursor_x);
+    if(selected == PAGE_CHAR) {
+        // Same cell on the next page; the whole grid is redrawn
+        page = (page + 1) % keys->pages;
+    } else if(selected == REMOVE_CHAR) {
+        if(length > 0) {
+            buffer[--length] = '\0';
         }
-        
-        delay(10);  // Small delay to prevent excessive polling
+    } else if(selected == LEFT_CHAR) {
+        // Special case: finish input (like BACK button)
+        state = KEYINPUT_DONE;
+    } else if(selected == RIGHT_CHAR || selected == SPACE_CHAR) {
+        type(' ');
+    } else if(selected != 0) {
+        type((char)selected);
     }
+}
+
+void KeyInput::type(char c) {
+    if(length < capacity) {
+        buffer[length++] = c;
+        buffer[length] = '\0';
+    }
+}
+
+bool KeyInput::isActive() const {
+    return state == KEYINPUT_ACTIVE;
+}
+
+const char* KeyInput::result() const {
+    return buffer;
+}
+
+size_t KeyInput::getLength() const {
+    return length;
+}
+
+size_t KeyInput::getCapacity() const {
+    return capacity;
+}
+
+// Blocking wrapper for callers with nothing else to do meanwhile
+const char* prompt_keyboard() {
+    static KeyInput keyboard(password_buffer, sizeof(password_buffer));
     
-    return password_buffer;
+    keyboard.begin();
+    while(!keyboard.poll()) {
+        runtime.waitFrame();
+    }
+    return keyboard.result();
 }
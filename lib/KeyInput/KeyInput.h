@@ -3,24 +3,95 @@
 
 #include <Arduino.h>
 #include "configs.h"  // Include centralized configuration
+#include "KeyLayout.h"
 
-// Function to display a keyboard and prompt for input
+// Control events produced by the input task
+enum InputEventType : uint8_t {
+  NAV_UP,
+  NAV_DOWN,
+  NAV_LEFT,
+  NAV_RIGHT,
+  NAV_SELECT,                   // Button pressed
+  NAV_RELEASE,
+  NAV_LONG_PRESS,
+  NAV_DOUBLE_PRESS
+};
+
+struct InputEvent {
+  uint8_t type;
+  uint32_t time_ms;  // When the control was sampled
+};
+
+#define KEYINPUT_MAX_LENGTH 63      // Longest WPA passphrase
+
+enum KeyInputState : uint8_t {
+  KEYINPUT_IDLE,
+  KEYINPUT_ACTIVE,
+  KEYINPUT_DONE
+};
+
+// On-screen keyboard as a state machine: begin() shows it, poll() applies
+// queued input and repaints what changed without blocking, and returns true
+// once the text is confirmed. The caller owns the text buffer, so the
+// capacity is whatever it passes (size - 1 characters).
+class KeyInput {
+private:
+  char* buffer;
+  size_t capacity;              // Characters, excluding the terminator
+  size_t length;
+  const KeyGrid* keys;
+  uint8_t state;
+  uint8_t page;
+  uint8_t cursor_x;
+  uint8_t cursor_y;
+  
+  // Undo for the key typed by the press that turns into a long press
+  size_t undo_pos;
+  char undo_char;
+  bool dirty;
+  
+  void handle(const InputEvent& event);
+  void type(char c);
+
+public:
+  // Constructor
+  KeyInput(char* buffer, size_t size);
+  
+  void begin();
+  bool poll();
+  void cancel();
+  
+  // Status methods
+  bool isActive() const;
+  const char* result() const;   // Text so far; final once poll() returned true
+  size_t getLength() const;
+  size_t getCapacity() const;
+};
+
+// Show the keyboard and block until input is confirmed (KEYINPUT_MAX_LENGTH)
 const char* prompt_keyboard();
 
 // Initialize analog inputs and button
 void init_controls();
 
-// Read potentiometer position and return movement direction
-int get_x_movement();
-int get_y_movement();
+// Sample pots and button once and queue any events (input task step)
+void sample_controls();
+
+// Take the next queued event; false when there is none
+bool next_input(InputEvent& event);
+
+// Drop events queued before a new screen takes over the controls
+void flush_input();
 
-// Check if the select button was pressed with debouncing
-bool select_button_pressed();
+// Draw the keyboard interface; only the cells and text that changed are
+// repainted and flushed once the full keyboard is on screen
+void draw_keyboard(uint8_t cursor_x, uint8_t cursor_y, const char* current_text, uint8_t page = 0);
 
-// Draw the keyboard interface
-void draw_keyboard(uint8_t cursor_x, uint8_t cursor_y, const char* current_text);
+// Force the next draw_keyboard() to repaint the whole screen
+void invalidate_keyboard();
 
-// The keyMap might need to be accessible in other files
-extern const char keyMap[6][18];
+// Keyboard layout (see KeyLayout.h); FREQUENCY_KEYS by default
+void set_keyboard_layout(const KeyGrid& keys);
+const KeyGrid& get_keyboard_layout();
 
 #endif // KEYINPUT_H
@@ -0,0 +1,37 @@
+#include "KeyLayout.h"
+
+// The original alphabetical grid. RIGHT_CHAR ("\x81") types a space too.
+static constexpr const char* CLASSIC_PAGES[] = {
+    KEY_DEL KEY_DONE "\x81" "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+    "0123456789!?@#$%^&*()-_+=|\\:;\"'<>,./~`[]{}" KEY_SPACE
+};
+static constexpr KeyLayout<1, 6, 18> CLASSIC_LAYOUT(CLASSIC_PAGES, PLACE_ROW_MAJOR, 0, 3);
+
+// Keys in order of frequency in WiFi passphrases: lowercase, digits and the
+// common symbols on the first page, capitals and the rest on the second.
+// PAGE sits on the home cell of both pages and DEL at the same position,
+// so switching pages never moves the cursor off either of them.
+static constexpr const char* FREQUENCY_PAGES[] = {
+    KEY_PAGE "ae1ior2nsl0tm39cd4h58u6y7bk" KEY_DEL "gpjvfw" KEY_SPACE "zxq.!_@-#$*&?+=%" KEY_DONE,
+    KEY_PAGE "AEIORNSLTMCDHUYBKGPJVFWZXQ," KEY_DEL "'\"()/:;<>[\\]^`{|}~" KEY_SPACE KEY_DONE
+};
+static constexpr KeyLayout<2, 6, 9> FREQUENCY_LAYOUT(FREQUENCY_PAGES, PLACE_NEAREST_FIRST, 2, 4);
+
+const KeyGrid CLASSIC_KEYS = CLASSIC_LAYOUT.grid();
+const KeyGrid FREQUENCY_KEYS = FREQUENCY_LAYOUT.grid();
+
+bool KeyGrid::find(uint8_t key, uint8_t& page, uint8_t& row, uint8_t& col) const {
+    for (uint8_t p = 0; p < pages; p++) {
+        for (uint8_t r = 0; r < rows; r++) {
+            for (uint8_t c = 0; c < cols; c++) {
+                if (this->key(p, r, c) == key) {
+                    page = p;
+                    row = r;
+                    col = c;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
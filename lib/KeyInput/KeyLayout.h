@@ -0,0 +1,141 @@
+#ifndef KEYLAYOUT_H
+#define KEYLAYOUT_H
+
+#include <Arduino.h>
+#include "configs.h"
+
+// Extra control key: switch to the next page of a multi-page layout
+#define PAGE_CHAR 131
+
+// Control keys inside layout sequences (string literal escapes)
+#define KEY_DEL   "\x7F"   // REMOVE_CHAR
+#define KEY_DONE  "\x80"   // LEFT_CHAR
+#define KEY_SPACE "\x82"   // SPACE_CHAR
+#define KEY_PAGE  "\x83"   // PAGE_CHAR
+
+// Screen geometry shared by every layout: the key grid fills the six text
+// rows below the "> text" line, columns split the full width evenly
+#define KEY_GRID_Y 16
+#define KEY_PITCH_Y 8
+#define KEY_GRID_ROWS ((SCREEN_HEIGHT - KEY_GRID_Y) / KEY_PITCH_Y)
+
+enum KeyPlacement : uint8_t {
+    PLACE_ROW_MAJOR,     // Sequence fills the page left to right, top to bottom
+    PLACE_NEAREST_FIRST  // Sequence fills outward from the home cell by cursor distance
+};
+
+// Pot steps between two positions on an axis that wraps around
+constexpr uint8_t wrap_distance(uint8_t a, uint8_t b, uint8_t size) {
+    return a > b ? (a - b < size - (a - b) ? a - b : size - (a - b))
+                 : (b - a < size - (b - a) ? b - a : size - (b - a));
+}
+
+// Glyph drawn for a key (one character cell each)
+constexpr char key_label(uint8_t key) {
+    return key == REMOVE_CHAR ? 0x1B :   // Left arrow (backspace)
+           key == LEFT_CHAR   ? '<' :
+           key == RIGHT_CHAR  ? '>' :
+           key == SPACE_CHAR  ? '_' :    // Show space as underscore
+           key == PAGE_CHAR   ? 0x18 :   // Up arrow (shift page)
+           key == 0           ? ' ' :
+           (char)key;
+}
+
+// Layout-independent view of a keyboard; what the drawing and input code use
+struct KeyGrid {
+    uint8_t pages;
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t pitch_x;
+    uint8_t home_row;
+    uint8_t home_col;
+    const uint8_t* keys;     // [page][row][col], 0 = empty cell
+    const char* labels;
+    const int16_t* cell_x;   // Left edge of each column
+    const int16_t* glyph_x;  // Glyph position inside the column
+    const int16_t* cell_y;   // Top edge of each row
+
+    uint8_t key(uint8_t page, uint8_t row, uint8_t col) const {
+        return keys[((uint16_t)page * rows + row) * cols + col];
+    }
+    char label(uint8_t page, uint8_t row, uint8_t col) const {
+        return labels[((uint16_t)page * rows + row) * cols + col];
+    }
+
+    // Cursor moves between two cells (both axes wrap)
+    uint8_t distance(uint8_t row0, uint8_t col0, uint8_t row1, uint8_t col1) const {
+        return wrap_distance(row0, row1, rows) + wrap_distance(col0, col1, cols);
+    }
+
+    // Locate a key; false when the layout does not have it
+    bool find(uint8_t key, uint8_t& page, uint8_t& row, uint8_t& col) const;
+};
+
+// Keyboard layout built at compile time from one key sequence per page.
+// Keys, labels and cell coordinates are constexpr tables, so a layout lives
+// in flash and adding one is just another template instance.
+template <uint8_t Pages, uint8_t Rows, uint8_t Cols>
+class KeyLayout {
+    static_assert(Rows <= KEY_GRID_ROWS, "Layout has more rows than the screen");
+    static_assert(Cols * 6 <= SCREEN_WIDTH, "Layout columns narrower than a glyph");
+
+public:
+    static constexpr uint8_t PITCH_X = SCREEN_WIDTH / Cols;
+    static constexpr uint16_t CELLS = Pages * Rows * Cols;
+
+    uint8_t keys[CELLS];
+    char labels[CELLS];
+    int16_t cell_x[Cols];
+    int16_t glyph_x[Cols];
+    int16_t cell_y[Rows];
+    uint8_t home_row;
+    uint8_t home_col;
+
+    constexpr KeyLayout(const char* const* sequences, KeyPlacement placement,
+                        uint8_t home_row, uint8_t home_col)
+        : keys(), labels(), cell_x(), glyph_x(), cell_y(), home_row(home_row), home_col(home_col) {
+        for (uint8_t col = 0; col < Cols; col++) {
+            cell_x[col] = col * PITCH_X;
+            glyph_x[col] = col * PITCH_X + (PITCH_X - 5) / 2;
+        }
+        for (uint8_t row = 0; row < Rows; row++) {
+            cell_y[row] = KEY_GRID_Y + row * KEY_PITCH_Y;
+        }
+
+        for (uint8_t page = 0; page < Pages; page++) {
+            const char* next = sequences[page];
+            uint8_t* cells = keys + page * Rows * Cols;
+
+            if (placement == PLACE_ROW_MAJOR) {
+                for (uint16_t i = 0; i < Rows * Cols && *next; i++) {
+                    cells[i] = (uint8_t)*next++;
+                }
+            } else {
+                // Rings of equal distance from home, each in reading order
+                for (uint8_t ring = 0; ring <= Rows / 2 + Cols / 2 && *next; ring++) {
+                    for (uint8_t row = 0; row < Rows; row++) {
+                        for (uint8_t col = 0; col < Cols && *next; col++) {
+                            if (wrap_distance(row, home_row, Rows) + wrap_distance(col, home_col, Cols) == ring) {
+                                cells[row * Cols + col] = (uint8_t)*next++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        for (uint16_t i = 0; i < CELLS; i++) {
+            labels[i] = key_label(keys[i]);
+        }
+    }
+
+    constexpr KeyGrid grid() const {
+        return {Pages, Rows, Cols, PITCH_X, home_row, home_col, keys, labels, cell_x, glyph_x, cell_y};
+    }
+};
+
+// Layouts shipped with the keyboard
+extern const KeyGrid CLASSIC_KEYS;    // Original 18x6 alphabetical grid
+extern const KeyGrid FREQUENCY_KEYS;  // Two 9x6 pages, frequent keys clustered
+
+#endif // KEYLAYOUT_H
@@ -0,0 +1,248 @@
+#include "NetworkListView.h"
+#include <WiFi.h>
+#include "Font5x7.h"
+
+// Row layout: SSID, lock for protected networks, four signal bars
+#define LOCK_X 111
+#define BARS_X 117
+#define BAR_PITCH 3
+
+#define SHOWN_UNKNOWN -2             // Screen row must be repainted
+#define SHOWN_BLANK -1               // Screen row is empty
+
+static const uint8_t lock_icon[FONT5X7_WIDTH] = {0x78, 0x7E, 0x5A, 0x7E, 0x78};
+
+NetworkListView::NetworkListView(PartialDisplay* disp)
+  : scroller(LIST_SSID_CHARS, LIST_SSID_CHARS * FONT5X7_ADVANCE) {
+  display = disp;
+  networks = nullptr;
+  selected = 0;
+  top = 0;
+  more_coming = false;
+  scroller_ssid[0] = '\0';
+  frame = 0;
+
+  for (int i = 0; i < LIST_CACHE_ROWS; i++) {
+    cache[i].valid = false;
+    cache[i].used = 0;
+  }
+
+  // Smooth scrolling at 20 pixels per second, 1.5 second pause at the ends
+  scroller.enableSmoothScroll(true, FONT5X7_ADVANCE);
+  scroller.setScrollStep(1);
+  scroller.setScrollDelay(50);
+  scroller.setPauseDelay(1500);
+
+  invalidate();
+  resetStats();
+}
+
+void NetworkListView::setNetworks(const std::vector<NetworkInfo>& list, bool scanning) {
+  networks = &list;
+  more_coming = scanning;
+  keepSelectionVisible();
+}
+
+void NetworkListView::setSelected(int index) {
+  selected = index;
+  keepSelectionVisible();
+}
+
+void NetworkListView::move(int delta) {
+  int count = networks ? networks->size() : 0;
+  if (count == 0) {
+    return;
+  }
+  selected = ((selected + delta) % count + count) % count;
+  keepSelectionVisible();
+}
+
+int NetworkListView::getSelected() const {
+  return selected;
+}
+
+int NetworkListView::getTop() const {
+  return top;
+}
+
+void NetworkListView::keepSelectionVisible() {
+  int count = networks ? networks->size() : 0;
+  selected = constrain(selected, 0, max(count - 1, 0));
+
+  if (selected < top) {
+    top = selected;
+  } else if (selected >= top + LIST_ROWS) {
+    top = selected - LIST_ROWS + 1;
+  }
+  // No blank rows at the bottom while there are networks above
+  top = constrain(top, 0, max(count - LIST_ROWS, 0));
+}
+
+void NetworkListView::invalidate() {
+  for (int r = 0; r < LIST_ROWS; r++) {
+    shown_slot[r] = SHOWN_UNKNOWN;
+    shown_highlight[r] = false;
+  }
+  shown_header_selected = -1;
+  shown_header_total = -1;
+  shown_header_more = false;
+}
+
+// Cache slot holding this network's row, rendered now if none does
+int NetworkListView::rowSlot(const NetworkInfo& network) {
+  uint8_t bars = signalBars(network.rssi);
+  bool locked = network.encryption != WIFI_AUTH_OPEN;
+
+  int victim = 0;
+  for (int i = 0; i < LIST_CACHE_ROWS; i++) {
+    Row& row = cache[i];
+    if (row.valid && row.bars == bars && row.locked == locked && strcmp(row.ssid, network.ssid) == 0) {
+      row.used = frame;
+      return i;
+    }
+    // Least recently shown; an empty slot counts as never shown
+    uint32_t age = row.valid ? row.used : 0;
+    uint32_t victim_age = cache[victim].valid ? cache[victim].used : 0;
+    if (age < victim_age) {
+      victim = i;
+    }
+  }
+
+  // Rows already placed this frame are newer than the victim; screen rows
+  // still showing its old content have to be repainted
+  for (int r = 0; r < LIST_ROWS; r++) {
+    if (shown_slot[r] == victim) {
+      shown_slot[r] = SHOWN_UNKNOWN;
+    }
+  }
+
+  Row& row = cache[victim];
+  strcpy(row.ssid, network.ssid);
+  row.bars = bars;
+  row.locked = locked;
+  row.valid = true;
+  row.used = frame;
+  renderRow(row);
+  return victim;
+}
+
+void NetworkListView::renderRow(Row& row) {
+  memset(row.columns, 0, sizeof(row.columns));
+
+  uint8_t* out = row.columns + LIST_SSID_X;
+  for (int i = 0; i < LIST_SSID_CHARS && row.ssid[i]; i++) {
+    const uint8_t* glyph = font5x7_glyph(row.ssid[i]);
+    for (int col = 0; col < FONT5X7_WIDTH; col++) {
+      out[col] = pgm_read_byte(&glyph[col]);
+    }
+    out += FONT5X7_ADVANCE;
+  }
+
+  if (row.locked) {
+    memcpy(row.columns + LOCK_X, lock_icon, sizeof(lock_icon));
+  }
+
+  // Bars grow from the bottom of the page (bit 7); an empty bar is a dot
+  for (int bar = 0; bar < 4; bar++) {
+    int height = bar < row.bars ? 1 + 2 * bar : 1;
+    uint8_t bits = 0xFF << (8 - height);
+    row.columns[BARS_X + bar * BAR_PITCH] = bits;
+    row.columns[BARS_X + bar * BAR_PITCH + 1] = bits;
+  }
+
+  rows_rendered++;
+}
+
+void NetworkListView::drawHeader() {
+  int total = networks ? networks->size() : 0;
+  if (selected == shown_header_selected && total == shown_header_total &&
+      more_coming == shown_header_more) {
+    return;
+  }
+
+  display->fillRect(0, 0, SCREEN_WIDTH, 8, SSD1306_BLACK);
+  display->setTextSize(1);
+  display->setTextColor(SSD1306_WHITE);
+  display->setCursor(0, 0);
+  display->print("Select network ");
+  if (total > 0) {
+    display->print(selected + 1);
+    display->print("/");
+    display->print(total);
+  }
+  if (more_coming) {
+    display->print("+");  // More channels still being scanned
+  }
+
+  shown_header_selected = selected;
+  shown_header_total = total;
+  shown_header_more = more_coming;
+}
+
+bool NetworkListView::update() {
+  return scroller.update();
+}
+
+void NetworkListView::draw() {
+  frame++;
+  keepSelectionVisible();
+  drawHeader();
+
+  uint8_t* buffer = display->getBuffer();
+  int count = networks ? networks->size() : 0;
+
+  for (int r = 0; r < LIST_ROWS; r++) {
+    int index = top + r;
+    uint8_t* dst = buffer + (LIST_FIRST_PAGE + r) * SCREEN_WIDTH;
+
+    if (index >= count) {
+      if (shown_slot[r] != SHOWN_BLANK) {
+        memset(dst, 0, SCREEN_WIDTH);
+        shown_slot[r] = SHOWN_BLANK;
+      }
+      continue;
+    }
+
+    const NetworkInfo& network = (*networks)[index];
+    bool highlight = (index == selected);
+    int slot = rowSlot(network);
+
+    if (slot != shown_slot[r] || highlight != shown_highlight[r]) {
+      const uint8_t* src = cache[slot].columns;
+      if (highlight) {
+        for (int col = 0; col < SCREEN_WIDTH; col++) {
+          dst[col] = ~src[col];
+        }
+      } else {
+        memcpy(dst, src, SCREEN_WIDTH);
+      }
+      shown_slot[r] = slot;
+      shown_highlight[r] = highlight;
+      rows_copied++;
+    }
+
+    if (highlight) {
+      if (strcmp(scroller_ssid, network.ssid) != 0) {
+        strcpy(scroller_ssid, network.ssid);
+        scroller.setText(scroller_ssid);
+      }
+      scroller.drawWithBackground(display, LIST_SSID_X, (LIST_FIRST_PAGE + r) * 8, 1,
+                                  SSD1306_BLACK, SSD1306_WHITE);
+    }
+  }
+
+  display->display();
+}
+
+uint32_t NetworkListView::getRowsRendered() const {
+  return rows_rendered;
+}
+
+uint32_t NetworkListView::getRowsCopied() const {
+  return rows_copied;
+}
+
+void NetworkListView::resetStats() {
+  rows_rendered = 0;
+  rows_copied = 0;
+}
@@ -0,0 +1,87 @@
+#ifndef NETWORKLISTVIEW_H
+#define NETWORKLISTVIEW_H
+
+#include <Arduino.h>
+#include <vector>
+#include "PartialDisplay.h"
+#include "ScrollingText.h"
+#include "ScanCollector.h"
+#include "configs.h"
+
+#define LIST_FIRST_PAGE 1                                // Page 0 is the header
+#define LIST_ROWS (SCREEN_HEIGHT / 8 - LIST_FIRST_PAGE)  // One network per page
+#define LIST_CACHE_ROWS (LIST_ROWS + 2)                  // Visible rows plus the next ones in
+#define LIST_SSID_X 2
+#define LIST_SSID_CHARS 18
+
+// Scrollable network list, one 8-pixel row per network. Only the visible
+// slice is drawn. Each row is rendered once into a page-layout bitmap (one
+// byte per column, the SSD1306 page format) and cached by content, so moving
+// the list copies the rows that stay on screen and renders only the row that
+// comes into view. The highlighted row is the cached row inverted, with the
+// one ScrollingText of the view running over its SSID. SSID bytes outside
+// printable ASCII are drawn as blank cells (see font5x7_glyph()).
+class NetworkListView {
+private:
+  struct Row {
+    char ssid[sizeof(NetworkInfo::ssid)];
+    uint8_t bars;              // getSignalStrength() of the network
+    bool locked;
+    bool valid;
+    uint32_t used;             // Frame last shown, for eviction
+    uint8_t columns[SCREEN_WIDTH];
+  };
+
+  PartialDisplay* display;
+  const std::vector<NetworkInfo>* networks;
+  int selected;
+  int top;                     // First visible network
+  bool more_coming;            // Scan still running: "+" after the count
+
+  ScrollingText scroller;      // Highlighted row only
+  char scroller_ssid[sizeof(NetworkInfo::ssid)];
+
+  Row cache[LIST_CACHE_ROWS];
+  uint32_t frame;
+
+  // What each screen row shows (cache slot, or -1 for blank / unknown)
+  int8_t shown_slot[LIST_ROWS];
+  bool shown_highlight[LIST_ROWS];
+  int shown_header_selected;
+  int shown_header_total;
+  bool shown_header_more;
+
+  // Statistics
+  uint32_t rows_rendered;      // Rows rendered from glyphs
+  uint32_t rows_copied;        // Rows copied from the cache into the frame
+
+  int rowSlot(const NetworkInfo& network);
+  void renderRow(Row& row);
+  void drawHeader();
+  void keepSelectionVisible();
+
+public:
+  // Constructor
+  explicit NetworkListView(PartialDisplay* disp);
+
+  // The list is read at every draw(); call again after it was replaced
+  void setNetworks(const std::vector<NetworkInfo>& list, bool scanning = false);
+  void setSelected(int index);
+  void move(int delta);        // Wraps at both ends
+  int getSelected() const;
+  int getTop() const;
+
+  // Advance the highlighted row's scroller; true when it moved
+  bool update();
+  // Paint the changed rows and the scroller, then flush
+  void draw();
+  // Repaint everything on the next draw() (another screen was shown)
+  void invalidate();
+
+  // Status methods
+  uint32_t getRowsRendered() const;
+  uint32_t getRowsCopied() const;
+  void resetStats();
+};
+
+#endif // NETWORKLISTVIEW_H
@@ -0,0 +1,169 @@
+#include "PageKernels.h"
+
+// Word access to byte buffers (GCC/Clang; Xtensa traps on unaligned words,
+// so only aligned addresses are accessed this way)
+typedef uint32_t __attribute__((__may_alias__)) page_word;
+
+static inline uint32_t lanes(uint8_t byte) {
+  return byte * 0x01010101UL;
+}
+
+// Clip a rectangle to [0, width) x [0, height); false when nothing is left
+static inline bool clip(int16_t width, int16_t height, int16_t& x, int16_t& y, int16_t& w, int16_t& h) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > width) w = width - x;
+  if (y + h > height) h = height - y;
+  return w > 0 && h > 0;
+}
+
+// Mask of the rows of page that lie in [y, y + h)
+static inline uint8_t page_mask(int16_t page, int16_t y, int16_t h) {
+  int16_t top = max((int16_t)(y - page * 8), (int16_t)0);
+  int16_t bottom = min((int16_t)(y + h - page * 8), (int16_t)8);
+  return (uint8_t)((0xFF << top) & (0xFF >> (8 - bottom)));
+}
+
+template <PageOp op>
+static inline void apply(uint8_t& byte, uint8_t mask) {
+  if (op == PAGE_SET) byte |= mask;
+  else if (op == PAGE_CLEAR) byte &= ~mask;
+  else byte ^= mask;
+}
+
+template <PageOp op>
+static inline void apply(page_word& word, uint32_t mask) {
+  if (op == PAGE_SET) word |= mask;
+  else if (op == PAGE_CLEAR) word &= ~mask;
+  else word ^= mask;
+}
+
+// Bytes up to a word boundary, whole words, then the remaining bytes
+template <PageOp op>
+static inline void fill_run(uint8_t* out, int16_t count, uint8_t mask) {
+  if (count < 8) {
+    // Too short to reach a whole word
+    while (count-- > 0) {
+      apply<op>(*out++, mask);
+    }
+    return;
+  }
+  while ((uintptr_t)out & 3) {
+    apply<op>(*out++, mask);
+    count--;
+  }
+  uint32_t mask32 = lanes(mask);
+  page_word* words = (page_word*)out;
+  for (; count >= 4; count -= 4) {
+    apply<op>(*words++, mask32);
+  }
+  out = (uint8_t*)words;
+  while (count-- > 0) {
+    apply<op>(*out++, mask);
+  }
+}
+
+// Partial masks on the first and last page, whole pages between
+template <PageOp op>
+static void fill_pages(const PageBuffer& dst, int16_t x, int16_t y, int16_t w, int16_t h) {
+  int16_t first = y >> 3;
+  int16_t last = (y + h - 1) >> 3;
+  uint8_t* out = dst.data + first * dst.width + x;
+  uint8_t top = 0xFF << (y & 7);
+  uint8_t bottom = 0xFF >> (7 - ((y + h - 1) & 7));
+  if (first == last) {
+    fill_run<op>(out, w, top & bottom);
+    return;
+  }
+  fill_run<op>(out, w, top);
+  for (int16_t page = first + 1; page < last; page++) {
+    out += dst.width;
+    fill_run<op>(out, w, 0xFF);
+  }
+  fill_run<op>(out + dst.width, w, bottom);
+}
+
+void page_fill(const PageBuffer& dst, int16_t x, int16_t y, int16_t w, int16_t h, PageOp op) {
+  if (!dst.data || !clip(dst.width, dst.height, x, y, w, h)) {
+    return;
+  }
+  switch (op) {
+    case PAGE_SET:    fill_pages<PAGE_SET>(dst, x, y, w, h);    break;
+    case PAGE_CLEAR:  fill_pages<PAGE_CLEAR>(dst, x, y, w, h);  break;
+    case PAGE_INVERT: fill_pages<PAGE_INVERT>(dst, x, y, w, h); break;
+  }
+}
+
+static inline uint32_t load_word(const uint8_t* p) {
+  uint32_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+// One destination page: each column byte is built from two source pages,
+// the upper one shifted down and the lower one shifted up
+static void copy_page(uint8_t* out, const uint8_t* upper, const uint8_t* lower,
+                      uint8_t shift, uint8_t mask, int16_t count) {
+  uint8_t keep_upper = 0xFF >> shift;
+  uint32_t keep_upper32 = lanes(keep_upper);
+  uint32_t mask32 = lanes(mask);
+
+  int16_t i = 0;
+  for (; i < count && ((uintptr_t)(out + i) & 3); i++) {
+    uint8_t bits = upper ? (upper[i] >> shift) & keep_upper : 0;
+    if (lower && shift) bits |= lower[i] << (8 - shift);
+    out[i] = (out[i] & ~mask) | (bits & mask);
+  }
+  for (; i + 4 <= count; i += 4) {
+    // Lanes shift separately: mask off the bits that crossed into a neighbour
+    uint32_t bits = upper ? (load_word(upper + i) >> shift) & keep_upper32 : 0;
+    if (lower && shift) bits |= (load_word(lower + i) << (8 - shift)) & ~keep_upper32;
+    page_word& word = *(page_word*)(out + i);
+    word = (word & ~mask32) | (bits & mask32);
+  }
+  for (; i < count; i++) {
+    uint8_t bits = upper ? (upper[i] >> shift) & keep_upper : 0;
+    if (lower && shift) bits |= lower[i] << (8 - shift);
+    out[i] = (out[i] & ~mask) | (bits & mask);
+  }
+}
+
+void page_copy_rect(const PageBuffer& dst, int16_t dx, int16_t dy,
+                    const PageBuffer& src, int16_t sx, int16_t sy, int16_t w, int16_t h) {
+  if (!dst.data || !src.data) {
+    return;
+  }
+
+  // Clip against the source, then the destination, moving the other corner along
+  int16_t x = sx, y = sy;
+  if (!clip(src.width, src.height, x, y, w, h)) {
+    return;
+  }
+  dx += x - sx;
+  dy += y - sy;
+  sx = x;
+  sy = y;
+  x = dx;
+  y = dy;
+  if (!clip(dst.width, dst.height, x, y, w, h)) {
+    return;
+  }
+  sx += x - dx;
+  sy += y - dy;
+  dx = x;
+  dy = y;
+
+  // Source row of destination row r is r + delta
+  int16_t delta = sy - dy;
+  int16_t src_pages = (src.height + 7) >> 3;
+  for (int16_t page = dy >> 3; page <= (dy + h - 1) >> 3; page++) {
+    int16_t first = page * 8 + delta;
+    int16_t upper_page = first >> 3;  // Arithmetic shift: floor for negative rows
+    uint8_t shift = first & 7;
+    const uint8_t* upper = (upper_page >= 0 && upper_page < src_pages)
+                         ? src.data + upper_page * src.width + sx : nullptr;
+    const uint8_t* lower = (upper_page + 1 >= 0 && upper_page + 1 < src_pages)
+                         ? src.data + (upper_page + 1) * src.width + sx : nullptr;
+    copy_page(dst.data + page * dst.width + dx, upper, lower, shift, page_mask(page, dy, h), w);
+  }
+}
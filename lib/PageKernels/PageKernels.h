@@ -0,0 +1,42 @@
+#ifndef PAGEKERNELS_H
+#define PAGEKERNELS_H
+
+#include <Arduino.h>
+
+// Rectangle operations on SSD1306 page memory: one byte per column per
+// 8-row page, LSB at the top. Each page row of a rectangle is one byte mask
+// repeated across its columns, so the kernels work on 32-bit words (four
+// columns at a time) with byte-wise edges. Rectangles are clipped to the
+// buffer.
+
+// A page-organized framebuffer (height rounded up to whole pages)
+struct PageBuffer {
+  uint8_t* data;
+  int16_t width;
+  int16_t height;
+};
+
+enum PageOp : uint8_t {
+  PAGE_SET,                    // Pixels on
+  PAGE_CLEAR,                  // Pixels off
+  PAGE_INVERT                  // Pixels flipped
+};
+
+void page_fill(const PageBuffer& dst, int16_t x, int16_t y, int16_t w, int16_t h, PageOp op);
+inline void page_fill_rect(const PageBuffer& dst, int16_t x, int16_t y, int16_t w, int16_t h) {
+  page_fill(dst, x, y, w, h, PAGE_SET);
+}
+inline void page_clear_rect(const PageBuffer& dst, int16_t x, int16_t y, int16_t w, int16_t h) {
+  page_fill(dst, x, y, w, h, PAGE_CLEAR);
+}
+inline void page_invert_rect(const PageBuffer& dst, int16_t x, int16_t y, int16_t w, int16_t h) {
+  page_fill(dst, x, y, w, h, PAGE_INVERT);
+}
+
+// Copy the w x h pixels at (sx, sy) in src to (dx, dy) in dst, shifting
+// bits across pages when the rows are not page aligned. Pixels of dst
+// outside the rectangle are kept. src and dst must not overlap.
+void page_copy_rect(const PageBuffer& dst, int16_t dx, int16_t dy,
+                    const PageBuffer& src, int16_t sx, int16_t sy, int16_t w, int16_t h);
+
+#endif // PAGEKERNELS_H
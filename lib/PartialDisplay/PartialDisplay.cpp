@@ -0,0 +1,514 @@
+#include "PartialDisplay.h"
+#include "Trace.h"
+
+// Largest write the Wire library accepts in one transaction
+#if defined(I2C_BUFFER_LENGTH)
+#define PARTIAL_WIRE_MAX min(256, I2C_BUFFER_LENGTH)
+#elif defined(BUFFER_LENGTH)
+#define PARTIAL_WIRE_MAX min(256, BUFFER_LENGTH)
+#else
+#define PARTIAL_WIRE_MAX 32
+#endif
+
+// Bytes a new address window costs on the bus (command transaction, data
+// control byte and two address bytes). Dirty runs separated by fewer clean
+// columns than this are cheaper to send as a single window.
+#define WINDOW_OVERHEAD 10
+
+#ifdef ARDUINO_ARCH_ESP32
+#define TRANSFER_TASK_PRIORITY 2     // Same as the render task
+#define TRANSFER_TASK_STACK 2048
+#endif
+
+PartialDisplay::PartialDisplay(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin)
+  : Adafruit_SSD1306(w, h, twi, rst_pin) {
+  shadow = nullptr;
+  shadow_valid = false;
+  front = nullptr;
+  transfer_pending = false;
+  job_page_start = 0;
+  job_page_end = 0;
+  job_col_start = 0;
+  job_col_end = 0;
+#ifdef ARDUINO_ARCH_ESP32
+  transfer_task = nullptr;
+  transfer_idle = nullptr;
+#endif
+  resetStats();
+}
+
+PartialDisplay::~PartialDisplay() {
+#ifdef ARDUINO_ARCH_ESP32
+  if (transfer_task) {
+    waitTransfer();
+    vTaskDelete(transfer_task);
+  }
+#endif
+  if (shadow) {
+    free(shadow);
+    shadow = nullptr;
+  }
+  if (front) {
+    free(front);
+    front = nullptr;
+  }
+}
+
+bool PartialDisplay::begin(uint8_t switchvcc, uint8_t i2caddr, bool reset, bool periphBegin) {
+  waitTransfer();
+  if (!Adafruit_SSD1306::begin(switchvcc, i2caddr, reset, periphBegin)) {
+    return false;
+  }
+
+  if (!shadow) {
+    shadow = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8));
+    if (!shadow) {
+      return false;
+    }
+  }
+
+  invalidate();
+  return true;
+}
+
+bool PartialDisplay::beginAsync() {
+  if (front) {
+    return true;
+  }
+  if (!buffer || !shadow) {
+    return false;  // begin() first
+  }
+
+  front = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8));
+  if (!front) {
+    return false;
+  }
+
+#ifdef ARDUINO_ARCH_ESP32
+  transfer_idle = xSemaphoreCreateBinary();
+  if (!transfer_idle) {
+    Serial.println("Failed to create display transfer semaphore");
+  } else {
+    xSemaphoreGive(transfer_idle);
+    if (xTaskCreate(transferTask, "display", TRANSFER_TASK_STACK, this,
+                    TRANSFER_TASK_PRIORITY, &transfer_task) != pdPASS) {
+      Serial.println("Failed to start display transfer task");
+      vSemaphoreDelete(transfer_idle);
+      transfer_idle = nullptr;
+      transfer_task = nullptr;
+    }
+  }
+#endif
+
+  return true;
+}
+
+bool PartialDisplay::isAsync() const {
+  return front != nullptr;
+}
+
+void PartialDisplay::setBusClock(uint32_t hz) {
+  waitTransfer();
+  wireClk = hz;
+}
+
+uint32_t PartialDisplay::getBusClock() const {
+  return wireClk;
+}
+
+void PartialDisplay::invalidate() {
+  waitTransfer();
+  shadow_valid = false;
+}
+
+void PartialDisplay::display() {
+  TRACE_SCOPE(TRACE_DISPLAY);
+
+  // Without I2C or a shadow buffer there is nothing to diff against
+  if (!wire || !shadow) {
+    Adafruit_SSD1306::display();
+    return;
+  }
+
+  if (front) {
+    handOff(0, (HEIGHT + 7) / 8 - 1, 0, WIDTH - 1);
+    return;
+  }
+  flushRegion(buffer, 0, (HEIGHT + 7) / 8 - 1, 0, WIDTH - 1);
+}
+
+// Classic font, size 1, unrotated, whole glyph on one page, plain colors
+bool PartialDisplay::glyphMode(int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                               uint8_t size_x, uint8_t size_y, GlyphMode& mode) const {
+  if (!buffer || size_x != 1 || size_y != 1 || getRotation() != 0 || (y & 7) != 0 ||
+      y < 0 || y >= HEIGHT || c < FONT5X7_FIRST || c >= FONT5X7_FIRST + FONT5X7_GLYPHS) {
+    return false;
+  }
+
+  if (bg == color) {
+    switch (color) {
+      case SSD1306_WHITE:   mode = GLYPH_OR;    return true;
+      case SSD1306_BLACK:   mode = GLYPH_CLEAR; return true;
+      case SSD1306_INVERSE: mode = GLYPH_XOR;   return true;
+      default:              return false;
+    }
+  }
+  if (color == SSD1306_WHITE && bg == SSD1306_BLACK) {
+    mode = GLYPH_SET;
+    return true;
+  }
+  if (color == SSD1306_BLACK && bg == SSD1306_WHITE) {
+    mode = GLYPH_SET_INVERSE;
+    return true;
+  }
+  return false;
+}
+
+// One byte per glyph column; opaque modes also paint the spacing column,
+// like drawChar() does with a background color
+void PartialDisplay::blitGlyph(int16_t x, uint8_t page, unsigned char c, GlyphMode mode) {
+  const uint8_t* glyph = font5x7_glyph(c);
+  uint8_t columns[FONT5X7_ADVANCE];
+  for (uint8_t i = 0; i < FONT5X7_WIDTH; i++) {
+    columns[i] = pgm_read_byte(&glyph[i]);
+  }
+  columns[FONT5X7_WIDTH] = 0;
+
+  int16_t from = max(x, (int16_t)0);
+  int16_t to = min((int16_t)(x + (mode >= GLYPH_SET ? FONT5X7_ADVANCE : FONT5X7_WIDTH)), (int16_t)WIDTH);
+  uint8_t* out = buffer + page * WIDTH;
+
+  switch (mode) {
+    case GLYPH_OR:          for (int16_t col = from; col < to; col++) out[col] |= columns[col - x];  break;
+    case GLYPH_CLEAR:       for (int16_t col = from; col < to; col++) out[col] &= ~columns[col - x]; break;
+    case GLYPH_XOR:         for (int16_t col = from; col < to; col++) out[col] ^= columns[col - x];  break;
+    case GLYPH_SET:         for (int16_t col = from; col < to; col++) out[col] = columns[col - x];   break;
+    case GLYPH_SET_INVERSE: for (int16_t col = from; col < to; col++) out[col] = ~columns[col - x];  break;
+  }
+}
+
+void PartialDisplay::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                              uint8_t size_x, uint8_t size_y) {
+  GlyphMode mode;
+  if (!glyphMode(y, c, color, bg, size_x, size_y, mode)) {
+    Adafruit_SSD1306::drawChar(x, y, c, color, bg, size_x, size_y);
+    return;
+  }
+  if (x < WIDTH && x + FONT5X7_ADVANCE > 0) {
+    blitGlyph(x, y >> 3, c, mode);
+  }
+}
+
+// Adafruit_GFX::write() for the classic font, calling the drawChar() above
+size_t PartialDisplay::write(uint8_t c) {
+  if (gfxFont || c == '\n' || c == '\r') {
+    return Adafruit_SSD1306::write(c);
+  }
+  if (wrap && (cursor_x + textsize_x * 6) > _width) {
+    cursor_x = 0;
+    cursor_y += textsize_y * 8;
+  }
+  drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+  cursor_x += textsize_x * 6;
+  return 1;
+}
+
+// print() of a string: the colors are checked once per run of glyphs that
+// stays on one line
+size_t PartialDisplay::write(const uint8_t* data, size_t size) {
+  size_t n = 0;
+  while (n < size) {
+    GlyphMode mode;
+    if (!gfxFont && glyphMode(cursor_y, FONT5X7_FIRST, textcolor, textbgcolor, textsize_x, textsize_y, mode)) {
+      for (; n < size; n++) {
+        uint8_t c = data[n];
+        if (c < FONT5X7_FIRST || c >= FONT5X7_FIRST + FONT5X7_GLYPHS ||
+            (wrap && cursor_x + FONT5X7_ADVANCE > _width)) {
+          break;
+        }
+        if (cursor_x < WIDTH && cursor_x + FONT5X7_ADVANCE > 0) {
+          blitGlyph(cursor_x, cursor_y >> 3, c, mode);
+        }
+        cursor_x += FONT5X7_ADVANCE;
+      }
+      if (n == size) {
+        break;
+      }
+    }
+    // Newline, wrap, unusual glyph or color: one character the slow way
+    write(data[n++]);
+  }
+  return size;
+}
+
+int16_t PartialDisplay::drawText(int16_t x, int16_t y, const char* text, uint16_t color) {
+  for (; *text; text++, x += FONT5X7_ADVANCE) {
+    drawChar(x, y, *text, color, color, 1, 1);
+  }
+  return x;
+}
+
+int16_t PartialDisplay::drawTextInverse(int16_t x, int16_t y, const char* text) {
+  for (; *text; text++, x += FONT5X7_ADVANCE) {
+    drawChar(x, y, *text, SSD1306_BLACK, SSD1306_WHITE, 1, 1);
+  }
+  return x;
+}
+
+bool PartialDisplay::pageOp(uint16_t color, PageOp& op) const {
+  if (!buffer || getRotation() != 0) {
+    return false;
+  }
+  switch (color) {
+    case SSD1306_WHITE:   op = PAGE_SET;    return true;
+    case SSD1306_BLACK:   op = PAGE_CLEAR;  return true;
+    case SSD1306_INVERSE: op = PAGE_INVERT; return true;
+    default:              return false;
+  }
+}
+
+PageBuffer PartialDisplay::pages() {
+  return {buffer, (int16_t)WIDTH, (int16_t)HEIGHT};
+}
+
+void PartialDisplay::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  PageOp op;
+  if (!pageOp(color, op)) {
+    Adafruit_SSD1306::fillRect(x, y, w, h, color);
+    return;
+  }
+  page_fill(pages(), x, y, w, h, op);
+}
+
+void PartialDisplay::invertRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  fillRect(x, y, w, h, SSD1306_INVERSE);
+}
+
+void PartialDisplay::copyRect(int16_t x, int16_t y, const PageBuffer& src, int16_t sx, int16_t sy,
+                              int16_t w, int16_t h) {
+  if (!buffer || getRotation() != 0) {
+    return;
+  }
+  page_copy_rect(pages(), x, y, src, sx, sy, w, h);
+}
+
+void PartialDisplay::displayRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  // The first frame has to go out whole before regions can be trusted
+  if (!wire || !shadow || !shadow_valid) {
+    display();
+    return;
+  }
+
+  int16_t x_end = min((int16_t)(x + w - 1), (int16_t)(WIDTH - 1));
+  int16_t y_end = min((int16_t)(y + h - 1), (int16_t)(HEIGHT - 1));
+  x = max(x, (int16_t)0);
+  y = max(y, (int16_t)0);
+  if (x > x_end || y > y_end) {
+    return;
+  }
+
+  if (front) {
+    handOff(y / 8, y_end / 8, x, x_end);
+    return;
+  }
+  flushRegion(buffer, y / 8, y_end / 8, x, x_end);
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+void PartialDisplay::transferTask(void* arg) {
+  PartialDisplay* self = (PartialDisplay*)arg;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    self->serviceTransfer();
+    xSemaphoreGive(self->transfer_idle);
+  }
+}
+#endif
+
+// Swap the finished frame to the front and queue it for the transfer. The
+// back buffer starts as a copy of it, since screens redraw only what changed.
+void PartialDisplay::handOff(uint8_t page_start, uint8_t page_end, uint8_t col_start, uint8_t col_end) {
+  // Wait for the previous frame to leave the front buffer
+  bool busy = transfer_pending;
+  unsigned long start = micros();
+#ifdef ARDUINO_ARCH_ESP32
+  if (transfer_task) {
+    xSemaphoreTake(transfer_idle, portMAX_DELAY);
+  } else
+#endif
+  serviceTransfer();
+  if (busy) {
+    wait_count++;
+    wait_us += micros() - start;
+  }
+
+  uint8_t* frame = buffer;
+  buffer = front;
+  front = frame;
+  memcpy(buffer, front, WIDTH * ((HEIGHT + 7) / 8));
+
+  job_page_start = page_start;
+  job_page_end = page_end;
+  job_col_start = col_start;
+  job_col_end = col_end;
+  transfer_pending = true;
+
+#ifdef ARDUINO_ARCH_ESP32
+  if (transfer_task) {
+    xTaskNotifyGive(transfer_task);
+  }
+#endif
+}
+
+void PartialDisplay::waitTransfer() {
+#ifdef ARDUINO_ARCH_ESP32
+  if (transfer_task) {
+    xSemaphoreTake(transfer_idle, portMAX_DELAY);
+    xSemaphoreGive(transfer_idle);
+    return;
+  }
+#endif
+  serviceTransfer();
+}
+
+bool PartialDisplay::serviceTransfer() {
+  if (!transfer_pending) {
+    return false;
+  }
+
+  unsigned long start = micros();
+  flushRegion(front, job_page_start, job_page_end, job_col_start, job_col_end);
+  transfer_us += micros() - start;
+  transfer_pending = false;
+  return true;
+}
+
+bool PartialDisplay::isTransferPending() const {
+  return transfer_pending;
+}
+
+// Diff and send the given pages and columns of a frame, then mark them clean
+void PartialDisplay::flushRegion(const uint8_t* frame, uint8_t page_start, uint8_t page_end,
+                                 uint8_t col_start, uint8_t col_end) {
+  bool sent = false;
+
+#if ARDUINO >= 157
+  wire->setClock(wireClk);
+#endif
+
+  for (uint8_t page = page_start; page <= page_end; page++) {
+    const uint8_t* cur = frame + page * WIDTH;
+    uint8_t* old = shadow + page * WIDTH;
+
+    int run_start = -1;
+    int run_end = -1;
+
+    for (int col = col_start; col <= col_end; col++) {
+      if (shadow_valid && cur[col] == old[col]) {
+        continue;
+      }
+
+      if (run_start >= 0 && col - run_end > WINDOW_OVERHEAD) {
+        // Gap too wide to bridge; flush the pending run first
+        sendWindow(frame, page, run_start, run_end);
+        sent = true;
+        run_start = -1;
+      }
+
+      if (run_start < 0) {
+        run_start = col;
+      }
+      run_end = col;
+    }
+
+    if (run_start >= 0) {
+      sendWindow(frame, page, run_start, run_end);
+      sent = true;
+    }
+  }
+
+#if ARDUINO >= 157
+  wire->setClock(restoreClk);
+#endif
+
+  if (sent) {
+    for (uint8_t page = page_start; page <= page_end; page++) {
+      memcpy(shadow + page * WIDTH + col_start, frame + page * WIDTH + col_start, col_end - col_start + 1);
+    }
+    shadow_valid = true;
+    flush_count++;
+  } else {
+    skipped_count++;
+  }
+}
+
+void PartialDisplay::sendWindow(const uint8_t* frame, uint8_t page, uint8_t col_start, uint8_t col_end) {
+  const uint8_t window[] = {
+    SSD1306_PAGEADDR, page, page,
+    SSD1306_COLUMNADDR, col_start, col_end
+  };
+  ssd1306_commandList(window, sizeof(window));
+  bytes_sent += 1 + sizeof(window);
+
+  const uint8_t* ptr = frame + page * WIDTH + col_start;
+  uint16_t count = col_end - col_start + 1;
+
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x40);  // Co = 0, D/C = 1
+  uint16_t bytes_out = 1;
+  bytes_sent++;
+
+  while (count--) {
+    if (bytes_out >= PARTIAL_WIRE_MAX) {
+      wire->endTransmission();
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x40);
+      bytes_out = 1;
+      bytes_sent++;
+    }
+    wire->write(*ptr++);
+    bytes_out++;
+    bytes_sent++;
+  }
+  wire->endTransmission();
+
+  window_count++;
+}
+
+uint32_t PartialDisplay::getFlushCount() const {
+  return flush_count;
+}
+
+uint32_t PartialDisplay::getSkippedCount() const {
+  return skipped_count;
+}
+
+uint32_t PartialDisplay::getWindowCount() const {
+  return window_count;
+}
+
+uint32_t PartialDisplay::getBytesSent() const {
+  return bytes_sent;
+}
+
+uint32_t PartialDisplay::getWaitCount() const {
+  return wait_count;
+}
+
+uint32_t PartialDisplay::getWaitUs() const {
+  return wait_us;
+}
+
+uint32_t PartialDisplay::getTransferUs() const {
+  return transfer_us;
+}
+
+void PartialDisplay::resetStats() {
+  flush_count = 0;
+  skipped_count = 0;
+  window_count = 0;
+  bytes_sent = 0;
+  wait_count = 0;
+  wait_us = 0;
+  transfer_us = 0;
+}
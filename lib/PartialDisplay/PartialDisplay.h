@@ -0,0 +1,142 @@
+#ifndef PARTIALDISPLAY_H
+#define PARTIALDISPLAY_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include <Adafruit_GFX.h>
+#include "Font5x7.h"
+#include "PageKernels.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#endif
+
+// SSD1306 driver that only sends the parts of the framebuffer that changed.
+// A shadow copy of the last transmitted frame is kept; display() diffs the
+// framebuffer against it page by page and sends each dirty column range
+// through a PAGEADDR/COLUMNADDR window. An unchanged frame sends zero bytes.
+//
+// After beginAsync() the driver is double buffered: display() hands the
+// finished frame to a transfer task and returns, and drawing continues on a
+// copy of it while the bus is busy. The next display() waits only if that
+// transfer has not finished yet, so a frame costs max(render, transfer)
+// instead of their sum. Without the task (native build) the pending transfer
+// runs inline in the next display() or waitTransfer(). Anything else that
+// talks on the same bus must call waitTransfer() first.
+//
+// Size 1 text of the classic font at a y that is a multiple of 8 skips the
+// GFX pixel loop: each glyph column is one framebuffer byte, combined with
+// a single OR, AND-NOT, XOR or store. print() takes that path through the
+// virtual write(); drawChar() is not virtual in Adafruit GFX, so only calls
+// made on a PartialDisplay get it. Anything else falls back to Adafruit GFX.
+// Likewise fillRect() (and fillScreen()) works on whole words of page memory.
+class PartialDisplay : public Adafruit_SSD1306 {
+private:
+  // How glyph columns are combined with the page
+  enum GlyphMode : uint8_t {
+    GLYPH_OR,                  // White, transparent
+    GLYPH_CLEAR,               // Black, transparent (AND-NOT)
+    GLYPH_XOR,                 // Inverse, transparent
+    GLYPH_SET,                 // White on black, spacing column included
+    GLYPH_SET_INVERSE          // Black on white (highlight)
+  };
+
+  uint8_t* shadow;             // Last frame sent to the panel
+  bool shadow_valid;           // False until a full frame has been sent
+
+  // Double buffering (beginAsync)
+  uint8_t* front;              // Frame owned by the transfer
+  volatile bool transfer_pending;
+  uint8_t job_page_start;      // Region of the pending transfer
+  uint8_t job_page_end;
+  uint8_t job_col_start;
+  uint8_t job_col_end;
+#ifdef ARDUINO_ARCH_ESP32
+  TaskHandle_t transfer_task;
+  SemaphoreHandle_t transfer_idle;  // Held from hand-off until the frame is sent
+#endif
+
+  // Statistics
+  uint32_t flush_count;        // display() calls that sent data
+  uint32_t skipped_count;      // display() calls with nothing to send
+  uint32_t window_count;       // Address windows sent
+  uint32_t bytes_sent;         // Bytes written to the bus (control + payload)
+  uint32_t wait_count;         // display() calls that waited for the bus
+  uint32_t wait_us;            // Time spent waiting for it
+  uint32_t transfer_us;        // Time spent sending frames
+
+  void flushRegion(const uint8_t* frame, uint8_t page_start, uint8_t page_end,
+                   uint8_t col_start, uint8_t col_end);
+  void sendWindow(const uint8_t* frame, uint8_t page, uint8_t col_start, uint8_t col_end);
+  void handOff(uint8_t page_start, uint8_t page_end, uint8_t col_start, uint8_t col_end);
+  bool glyphMode(int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                 uint8_t size_x, uint8_t size_y, GlyphMode& mode) const;
+  void blitGlyph(int16_t x, uint8_t page, unsigned char c, GlyphMode mode);
+  bool pageOp(uint16_t color, PageOp& op) const;
+
+#ifdef ARDUINO_ARCH_ESP32
+  static void transferTask(void* arg);
+#endif
+
+public:
+  // Constructor
+  PartialDisplay(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1);
+  ~PartialDisplay();
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0,
+             bool reset = true, bool periphBegin = true);
+  // Allocate the second framebuffer and start the transfer task
+  bool beginAsync();
+  bool isAsync() const;
+  // I2C clock while sending frames (400 kHz fast mode, 1 MHz fast mode plus)
+  void setBusClock(uint32_t hz);
+  uint32_t getBusClock() const;
+
+  // Send the dirty regions of the framebuffer (hides Adafruit_SSD1306::display)
+  void display();
+  // Send only the dirty part of one rectangle; the rest stays pending
+  void displayRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  // Force the next display() to resend the whole frame
+  void invalidate();
+
+  // Text (same results as Adafruit GFX, page-aligned fast path). drawChar()
+  // hides the GFX one: call it on a PartialDisplay, not an Adafruit_GFX*
+  using Adafruit_SSD1306::drawChar;
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                uint8_t size_x, uint8_t size_y);
+  using Adafruit_SSD1306::write;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* data, size_t size) override;
+  // Size 1 string at (x, y) without moving the cursor; returns the x after it
+  int16_t drawText(int16_t x, int16_t y, const char* text, uint16_t color = SSD1306_WHITE);
+  // Black on white, spacing columns filled: the keyboard highlight
+  int16_t drawTextInverse(int16_t x, int16_t y, const char* text);
+
+  // Rectangles (word-wise on the framebuffer when unrotated)
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void invertRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  // Copy pixels from another page buffer, keeping the rest of the frame
+  void copyRect(int16_t x, int16_t y, const PageBuffer& src, int16_t sx, int16_t sy, int16_t w, int16_t h);
+  PageBuffer pages();
+
+  // Block until the frame handed off last is on the panel
+  void waitTransfer();
+  // Send the pending frame now, if any (the transfer task's step)
+  bool serviceTransfer();
+  bool isTransferPending() const;
+
+  // Status methods
+  uint32_t getFlushCount() const;
+  uint32_t getSkippedCount() const;
+  uint32_t getWindowCount() const;
+  uint32_t getBytesSent() const;
+  uint32_t getWaitCount() const;
+  uint32_t getWaitUs() const;
+  uint32_t getTransferUs() const;
+  void resetStats();
+};
+
+#endif // PARTIALDISPLAY_H
@@ -0,0 +1,99 @@
+#include "ScanCollector.h"
+#include <algorithm>
+
+// Heap order: the weakest entry sits at the front
+static bool stronger(const NetworkInfo& a, const NetworkInfo& b) {
+  return a.rssi > b.rssi;
+}
+
+ScanCollector::ScanCollector(uint8_t top_k) {
+  limit = SCAN_TOP_K;
+  setLimit(top_k);
+  clear();
+}
+
+void ScanCollector::clear() {
+  count = 0;
+  changed = true;
+  seen_count = 0;
+  merged_count = 0;
+  dropped_count = 0;
+}
+
+void ScanCollector::setLimit(uint8_t top_k) {
+  limit = constrain(top_k, 1, SCAN_TOP_K);
+}
+
+int ScanCollector::find(const char* ssid) const {
+  for (int i = 0; i < count; i++) {
+    if (strcmp(entries[i].ssid, ssid) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool ScanCollector::add(const NetworkInfo& network) {
+  seen_count++;
+  
+  // Hidden networks have nothing to merge on
+  int index = network.ssid[0] ? find(network.ssid) : -1;
+  if (index >= 0) {
+    merged_count++;
+    if (network.rssi <= entries[index].rssi) {
+      return false;
+    }
+    entries[index] = network;
+    std::make_heap(entries, entries + count, stronger);
+    changed = true;
+    return true;
+  }
+  
+  if (count < limit) {
+    entries[count++] = network;
+    std::push_heap(entries, entries + count, stronger);
+    changed = true;
+    return true;
+  }
+  
+  // Full: only a network stronger than the weakest kept one gets in
+  dropped_count++;
+  if (network.rssi <= entries[0].rssi) {
+    return false;
+  }
+  std::pop_heap(entries, entries + count, stronger);
+  entries[count - 1] = network;
+  std::push_heap(entries, entries + count, stronger);
+  changed = true;
+  return true;
+}
+
+void ScanCollector::sortedInto(std::vector<NetworkInfo>& out) {
+  out.assign(entries, entries + count);
+  std::sort_heap(out.begin(), out.end(), stronger);
+  changed = false;
+}
+
+uint8_t ScanCollector::size() const {
+  return count;
+}
+
+uint8_t ScanCollector::getLimit() const {
+  return limit;
+}
+
+bool ScanCollector::hasChanged() const {
+  return changed;
+}
+
+uint32_t ScanCollector::getSeenCount() const {
+  return seen_count;
+}
+
+uint32_t ScanCollector::getMergedCount() const {
+  return merged_count;
+}
+
+uint32_t ScanCollector::getDroppedCount() const {
+  return dropped_count;
+}
@@ -0,0 +1,68 @@
+#ifndef SCANCOLLECTOR_H
+#define SCANCOLLECTOR_H
+
+#include <Arduino.h>
+#include <vector>
+
+#define SCAN_TOP_K 48                // Networks kept from one scan
+
+// One network from a scan. Fixed size, so scan results move through queues
+// and vectors without touching the heap.
+struct NetworkInfo {
+  char ssid[33];               // "" for a hidden network
+  uint8_t bssid[6];            // Strongest access point seen for this SSID
+  uint8_t channel;             // Its primary channel
+  int8_t rssi;
+  uint8_t encryption;          // wifi_auth_mode_t
+};
+
+// Signal bars for an RSSI: 4 excellent, 3 good, 2 fair, 1 weak, 0 very weak
+inline int signalBars(int32_t rssi) {
+  if (rssi >= -50) return 4;
+  if (rssi >= -60) return 3;
+  if (rssi >= -70) return 2;
+  if (rssi >= -80) return 1;
+  return 0;
+}
+
+// Keeps the strongest networks of a scan. Entries live in a fixed array
+// ordered as a min-heap on RSSI, so a full collector replaces its weakest
+// entry in O(log K). Several access points of one SSID collapse into a single
+// entry that carries the strongest BSSID and channel.
+class ScanCollector {
+private:
+  NetworkInfo entries[SCAN_TOP_K];
+  uint8_t count;
+  uint8_t limit;
+  bool changed;                // Entries differ from the last sorted copy
+  
+  // Statistics
+  uint32_t seen_count;
+  uint32_t merged_count;
+  uint32_t dropped_count;
+  
+  int find(const char* ssid) const;
+  void siftUp(int index);
+  void siftDown(int index);
+
+public:
+  // Constructor
+  explicit ScanCollector(uint8_t top_k = SCAN_TOP_K);
+  
+  void clear();
+  void setLimit(uint8_t top_k);  // Clamped to SCAN_TOP_K; applies after clear()
+  bool add(const NetworkInfo& network);  // True when the kept set changed
+  
+  // Strongest first. Reuses out's storage; reserve SCAN_TOP_K once up front.
+  void sortedInto(std::vector<NetworkInfo>& out);
+  
+  // Status methods
+  uint8_t size() const;
+  uint8_t getLimit() const;
+  bool hasChanged() const;
+  uint32_t getSeenCount() const;
+  uint32_t getMergedCount() const;    // Duplicate SSIDs folded into an entry
+  uint32_t getDroppedCount() const;   // Too weak for a full collector, or evicted
+};
+
+#endif // SCANCOLLECTOR_H
@@ -1,4 +1,5 @@
 #include "ScrollingText.h"
+#include "Trace.h"
 
 ScrollingText::ScrollingText(int max_chars, int pixel_w, unsigned long scroll_ms, unsigned long pause_ms) {
   display_width = max_chars;
@@ -17,16 +18,29 @@ ScrollingText::ScrollingText(int max_chars, int pixel_w, unsigned long scroll_ms
   loop_enabled = true;
   smooth_scroll_enabled = true;
   pixels_per_char = 6;  // Default for text size 1
+  scroll_step = 1;
   
-  text = "";
-  display_text = "";
+  text[0] = '\0';
+  text_length = 0;
+  strip_width = 0;
 }
 
 void ScrollingText::setText(const String& new_text) {
-  text = new_text;
+  setText(new_text.c_str());
+}
+
+void ScrollingText::setText(const char* new_text) {
+  // Copy into the inline buffer, truncating anything past MAX_TEXT_LENGTH
+  text_length = 0;
+  while (new_text && new_text[text_length] && text_length < MAX_TEXT_LENGTH) {
+    text[text_length] = new_text[text_length];
+    text_length++;
+  }
+  text[text_length] = '\0';
+  
   reset();
   calculateScrollNeeds();
-  updateDisplayText();
+  renderStrip();
 }
 
 void ScrollingText::setDisplayWidth(int chars, int pixels) {
@@ -35,7 +49,6 @@ void ScrollingText::setDisplayWidth(int chars, int pixels) {
     pixel_width = pixels;
   }
   calculateScrollNeeds();
-  updateDisplayText();
 }
 
 void ScrollingText::setScrollDelay(unsigned long delay_ms) {
@@ -48,6 +61,7 @@ void ScrollingText::setPauseDelay(unsigned long pause_ms) {
 
 void ScrollingText::enableLoop(bool enable) {
   loop_enabled = enable;
+  renderStrip();
 }
 
 void ScrollingText::enableSmoothScroll(bool enable, int pixels_per_char) {
@@ -57,6 +71,12 @@ void ScrollingText::enableSmoothScroll(bool enable, int pixels_per_char) {
   }
 }
 
+void ScrollingText::setScrollStep(int pixels) {
+  if (pixels > 0) {
+    scroll_step = pixels;
+  }
+}
+
 void ScrollingText::setScrollDirection(bool right_to_left) {
   scroll_direction = right_to_left;
 }
@@ -80,51 +100,137 @@ void ScrollingText::resume() {
 }
 
 void ScrollingText::calculateScrollNeeds() {
-  needs_scrolling = (text.length() > display_width);
+  needs_scrolling = (text_length > display_width);
 }
 
-void ScrollingText::updateDisplayText() {
-  if (!needs_scrolling) {
-    display_text = text;
-    return;
+int ScrollingText::ringLength() const {
+  // A looping text wraps through one separating space
+  return loop_enabled ? text_length + 1 : text_length;
+}
+
+char ScrollingText::charAt(int ring_index) const {
+  int length = ringLength();
+  if (length == 0) {
+    return ' ';
+  }
+  if (loop_enabled) {
+    ring_index %= length;
+  }
+  return (ring_index < text_length) ? text[ring_index] : ' ';
+}
+
+void ScrollingText::renderStrip() {
+  int length = ringLength();
+  uint8_t* out = strip;
+  
+  for (int i = 0; i < length; i++) {
+    const uint8_t* glyph = font5x7_glyph(charAt(i));
+    for (int col = 0; col < FONT5X7_WIDTH; col++) {
+      *out++ = pgm_read_byte(&glyph[col]);
+    }
+    *out++ = 0;  // Spacing column
   }
   
-  if (smooth_scroll_enabled) {
-    // For smooth scrolling, we need to show partial characters
-    int char_start = scroll_position;
-    int char_end = scroll_position + display_width + 1;  // +1 for partial character
-    
-    if (char_end > text.length()) {
-      if (loop_enabled) {
-        // Wrap around with loop
-        display_text = text.substring(char_start) + " " + text.substring(0, char_end - text.length());
-      } else {
-        display_text = text.substring(char_start);
+  strip_width = length * FONT5X7_ADVANCE;
+}
+
+bool ScrollingText::canBlit(Adafruit_SSD1306* display, int text_size) const {
+  // The strip holds size 1 glyphs in unrotated page layout
+  return text_size == 1 && pixels_per_char == FONT5X7_ADVANCE &&
+         display->getRotation() == 0 && display->getBuffer() != nullptr;
+}
+
+static inline void applyColumn(uint8_t* dst, uint8_t bits, uint16_t color) {
+  if (color == SSD1306_WHITE) *dst |= bits;
+  else if (color == SSD1306_BLACK) *dst &= ~bits;
+  else *dst ^= bits;
+}
+
+void ScrollingText::blitStrip(Adafruit_SSD1306* display, int x, int y, uint16_t color,
+                              bool fill_bg, uint16_t bg_color) {
+  uint8_t* buffer = display->getBuffer();
+  int width = display->width();
+  int pages = (display->height() + 7) / 8;
+  
+  // Source column of the window's left edge
+  int start = 0;
+  int columns = display_width * FONT5X7_ADVANCE;
+  if (needs_scrolling) {
+    start = scroll_position * pixels_per_char + (smooth_scroll_enabled ? pixel_offset : 0);
+    columns = pixel_width;
+  }
+  bool wrap = needs_scrolling && loop_enabled && strip_width > 0;
+  PageBuffer frame = {buffer, (int16_t)width, (int16_t)display->height()};
+  
+  // White on black is a plain copy of the strip, one run per wrap
+  if (fill_bg && color == SSD1306_WHITE && bg_color == SSD1306_BLACK) {
+    PageBuffer source = {strip, (int16_t)strip_width, FONT5X7_HEIGHT};
+    int src = wrap ? start % strip_width : start;
+    for (int done = 0; done < columns; ) {
+      int run = min(columns - done, strip_width - src);
+      if (run <= 0) {
+        // Past the end of text that does not loop
+        page_clear_rect(frame, x + done, y, columns - done, FONT5X7_HEIGHT);
+        break;
       }
-    } else {
-      display_text = text.substring(char_start, char_end);
+      page_copy_rect(frame, x + done, y, source, src, 0, run, FONT5X7_HEIGHT);
+      done += run;
+      src = wrap ? 0 : strip_width;
     }
-  } else {
-    // Character-by-character scrolling
-    int char_end = scroll_position + display_width;
+    return;
+  }
+  
+  // Other colors: background first, then the glyphs over it
+  if (fill_bg) {
+    PageOp op = bg_color == SSD1306_WHITE ? PAGE_SET : bg_color == SSD1306_BLACK ? PAGE_CLEAR : PAGE_INVERT;
+    page_fill(frame, x, y, columns, FONT5X7_HEIGHT, op);
+  }
+  
+  // A row of text straddles two pages unless y is page aligned
+  int page = y >> 3;
+  int shift = y & 7;
+  bool low_visible = page >= 0 && page < pages;
+  bool high_visible = shift && page + 1 >= 0 && page + 1 < pages;
+  uint8_t* low = low_visible ? buffer + page * width : nullptr;
+  uint8_t* high = high_visible ? buffer + (page + 1) * width : nullptr;
+  
+  int src = wrap ? start % strip_width : start;
+  for (int i = 0; i < columns; i++, src++) {
+    if (wrap && src >= strip_width) {
+      src = 0;
+    }
+    int dx = x + i;
+    if (dx < 0) continue;
+    if (dx >= width) break;
     
-    if (char_end > text.length()) {
-      if (loop_enabled) {
-        display_text = text.substring(scroll_position) + " " + text.substring(0, char_end - text.length());
-      } else {
-        display_text = text.substring(scroll_position);
-      }
-    } else {
-      display_text = text.substring(scroll_position, char_end);
+    uint8_t bits = (src < strip_width) ? strip[src] : 0;
+    if (low_visible) {
+      applyColumn(&low[dx], bits << shift, color);
+    }
+    if (high_visible) {
+      applyColumn(&high[dx], bits >> (8 - shift), color);
     }
   }
 }
 
-void ScrollingText::update() {
+void ScrollingText::printWindow(Adafruit_SSD1306* display) {
   if (!needs_scrolling) {
+    display->print(text);
     return;
   }
   
+  // Smooth scrolling shows one extra, partially visible character
+  int chars = smooth_scroll_enabled ? display_width + 1 : display_width;
+  for (int i = 0; i < chars; i++) {
+    display->write((uint8_t)charAt(scroll_position + i));
+  }
+}
+
+bool ScrollingText::update() {
+  if (!needs_scrolling) {
+    return false;
+  }
+  
   unsigned long current_time = millis();
   
   // Handle pause at start/end
@@ -133,74 +239,82 @@ void ScrollingText::update() {
       is_paused = false;
       last_scroll_time = current_time;
     }
-    return;
+    return false;
   }
   
   // Check if it's time to scroll
   if (current_time - last_scroll_time < scroll_delay) {
-    return;
+    return false;
   }
   
+  TRACE_SCOPE(TRACE_SCROLL);  // Real steps only, not idle frames
+  
   if (smooth_scroll_enabled) {
     // Smooth pixel-by-pixel scrolling
-    pixel_offset += 2;  // Move 2 pixels at a time for smooth effect
+    pixel_offset += scroll_step;
     
     if (pixel_offset >= pixels_per_char) {
       pixel_offset = 0;
       scroll_position++;
       
       // Check for end of text
-      if (scroll_position >= text.length()) {
-        if (loop_enabled) {
-          scroll_position = 0;
-          is_paused = true;
-          pause_start_time = current_time;
-        } else {
-          scroll_position = text.length() - display_width;
-          is_paused = true;
-          pause_start_time = current_time;
-        }
+      if (scroll_position >= ringLength()) {
+        scroll_position = loop_enabled ? 0 : text_length - display_width;
+        is_paused = true;
+        pause_start_time = current_time;
       }
     }
   } else {
     // Character-by-character scrolling
     scroll_position++;
     
-    if (scroll_position >= text.length()) {
-      if (loop_enabled) {
-        scroll_position = 0;
-        is_paused = true;
-        pause_start_time = current_time;
-      } else {
-        scroll_position = text.length() - display_width;
-        is_paused = true;
-        pause_start_time = current_time;
-      }
+    if (scroll_position >= ringLength()) {
+      scroll_position = loop_enabled ? 0 : text_length - display_width;
+      is_paused = true;
+      pause_start_time = current_time;
     }
   }
   
   last_scroll_time = current_time;
-  updateDisplayText();
+  return true;
 }
 
 String ScrollingText::getCurrentDisplayText() {
-  return display_text;
+  if (!needs_scrolling) {
+    return String(text);
+  }
+  
+  char window[MAX_TEXT_LENGTH + 2];
+  int chars = smooth_scroll_enabled ? display_width + 1 : display_width;
+  if (chars > MAX_TEXT_LENGTH + 1) {
+    chars = MAX_TEXT_LENGTH + 1;
+  }
+  for (int i = 0; i < chars; i++) {
+    window[i] = charAt(scroll_position + i);
+  }
+  window[chars] = '\0';
+  return String(window);
 }
 
 void ScrollingText::draw(Adafruit_SSD1306* display, int x, int y, int text_size, uint16_t color) {
+  if (canBlit(display, text_size)) {
+    blitStrip(display, x, y, color, false, color);
+    return;
+  }
+  
   display->setTextSize(text_size);
   display->setTextColor(color);
   display->setCursor(x - pixel_offset, y);  // Apply smooth scroll offset
-  
-  if (needs_scrolling) {
-    display->print(display_text);
-  } else {
-    display->print(text);
-  }
+  printWindow(display);
 }
 
 void ScrollingText::drawWithBackground(Adafruit_SSD1306* display, int x, int y, int text_size, 
                                      uint16_t text_color, uint16_t bg_color) {
+  if (canBlit(display, text_size)) {
+    blitStrip(display, x, y, text_color, true, bg_color);
+    return;
+  }
+  
   // Clear background area first
   int char_width = 6 * text_size;
   int char_height = 8 * text_size;
@@ -212,12 +326,7 @@ void ScrollingText::drawWithBackground(Adafruit_SSD1306* display, int x, int y,
   display->setTextSize(text_size);
   display->setTextColor(text_color);
   display->setCursor(x - pixel_offset, y);
-  
-  if (needs_scrolling) {
-    display->print(display_text);
-  } else {
-    display->print(text);
-  }
+  printWindow(display);
 }
 
 bool ScrollingText::isScrolling() const {
@@ -233,5 +342,5 @@ int ScrollingText::getScrollPosition() const {
 }
 
 String ScrollingText::getOriginalText() const {
-  return text;
+  return String(text);
 }
@@ -4,11 +4,19 @@
 #include <Arduino.h>
 #include <Adafruit_SSD1306.h>
 #include <Adafruit_GFX.h>
+#include "Font5x7.h"
+#include "PageKernels.h"
 
 class ScrollingText {
+public:
+  // Longest text kept (SSIDs are at most 32 bytes)
+  static const int MAX_TEXT_LENGTH = 32;
+
 private:
-  String text;
-  String display_text;
+  // Text is stored inline and the visible window is read straight from a
+  // wrap-around index, so update() and draw() never touch the heap
+  char text[MAX_TEXT_LENGTH + 1];
+  int text_length;
   int display_width;           // Maximum characters to display
   int pixel_width;            // Pixel width of display area
   int scroll_position;        // Current scroll position (in characters)
@@ -24,10 +32,23 @@ private:
   // Smooth scrolling variables
   int pixel_offset;            // Current pixel offset for smooth scrolling
   int pixels_per_char;         // Pixels per character (usually 6 for size 1)
+  int scroll_step;             // Pixels moved per smooth scroll step
   bool smooth_scroll_enabled;
   
-  void updateDisplayText();
+  // Text pre-rendered by setText() as 1-bpp page columns, one byte per
+  // pixel column, so each frame is a column copy instead of glyph drawing.
+  // Non-ASCII bytes are blank cells here; only the GFX fallback in
+  // printWindow() (other sizes, rotation) still draws their cp437 glyphs
+  uint8_t strip[(MAX_TEXT_LENGTH + 1) * FONT5X7_ADVANCE];
+  int strip_width;             // Rendered columns (ring length * 6)
+  
   void calculateScrollNeeds();
+  int ringLength() const;
+  char charAt(int ring_index) const;
+  void renderStrip();
+  bool canBlit(Adafruit_SSD1306* display, int text_size) const;
+  void blitStrip(Adafruit_SSD1306* display, int x, int y, uint16_t color, bool fill_bg, uint16_t bg_color);
+  void printWindow(Adafruit_SSD1306* display);
   
 public:
   // Constructor
@@ -35,18 +56,20 @@ public:
   
   // Configuration methods
   void setText(const String& new_text);
+  void setText(const char* new_text);
   void setDisplayWidth(int chars, int pixels = -1);
   void setScrollDelay(unsigned long delay_ms);
   void setPauseDelay(unsigned long pause_ms);
   void enableLoop(bool enable = true);
   void enableSmoothScroll(bool enable = true, int pixels_per_char = 6);
+  void setScrollStep(int pixels);
   void setScrollDirection(bool right_to_left = true);
   
   // Control methods
   void reset();
   void pause();
   void resume();
-  void update();  // Call this regularly to update scroll position
+  bool update();  // Call this regularly; true when the visible window moved
   
   // Display methods
   String getCurrentDisplayText();
@@ -0,0 +1,168 @@
+#include "SleepCycle.h"
+#include <WiFi.h>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_sleep.h>
+#endif
+
+// Survives deep sleep; zeroed on power-on, so the magic check fails there
+RTC_DATA_ATTR static WakeState rtc_state;
+
+SleepCycle::SleepCycle() {
+  woke = false;
+  connect_ms = 0;
+  sleep_seconds = 0;
+}
+
+uint32_t SleepCycle::checksumOf(const WakeState& state) {
+  const uint8_t* bytes = (const uint8_t*)&state;
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < offsetof(WakeState, checksum); i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+void SleepCycle::seal() {
+  rtc_state.checksum = checksumOf(rtc_state);
+}
+
+bool SleepCycle::begin() {
+  bool valid = rtc_state.magic == WAKE_STATE_MAGIC && rtc_state.version == WAKE_STATE_VERSION &&
+               rtc_state.checksum == checksumOf(rtc_state);
+#ifdef ARDUINO_ARCH_ESP32
+  woke = valid && esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+#else
+  woke = valid && rtc_state.last_awake_ms > 0;
+#endif
+
+  if (!woke) {
+    // Power-on, reset or a layout from another firmware: start clean
+    memset(&rtc_state, 0, sizeof(rtc_state));
+    rtc_state.magic = WAKE_STATE_MAGIC;
+    rtc_state.version = WAKE_STATE_VERSION;
+  }
+  rtc_state.wake_count++;
+  connect_ms = 0;
+  seal();
+
+  if (woke) {
+    Serial.printf("Wake %lu: last cycle awake %lu ms, online after %lu ms\n",
+                  (unsigned long)rtc_state.wake_count, (unsigned long)rtc_state.last_awake_ms,
+                  (unsigned long)rtc_state.last_connect_ms);
+  }
+  return woke;
+}
+
+bool SleepCycle::isWake() const {
+  return woke;
+}
+
+bool SleepCycle::hasNetwork() const {
+  return rtc_state.network.ssid[0] != '\0' && rtc_state.network.channel != 0;
+}
+
+const SavedNetwork& SleepCycle::getNetwork() const {
+  return rtc_state.network;
+}
+
+const StaticIp* SleepCycle::getStaticIp() const {
+  return rtc_state.ip.ip ? &rtc_state.ip : nullptr;
+}
+
+void SleepCycle::recordConnection(const SavedNetwork& network) {
+  rtc_state.network = network;
+  // The driver knows the AP that actually answered
+  const uint8_t* bssid = WiFi.BSSID();
+  if (bssid) {
+    memcpy(rtc_state.network.bssid, bssid, sizeof(rtc_state.network.bssid));
+    rtc_state.network.channel = WiFi.channel();
+    rtc_state.network.last_rssi = WiFi.RSSI();
+  }
+
+  rtc_state.ip.ip = WiFi.localIP();
+  rtc_state.ip.gateway = WiFi.gatewayIP();
+  rtc_state.ip.subnet = WiFi.subnetMask();
+  rtc_state.ip.dns = WiFi.dnsIP();
+  seal();
+}
+
+void SleepCycle::forgetNetwork() {
+  memset(&rtc_state.network, 0, sizeof(rtc_state.network));
+  memset(&rtc_state.ip, 0, sizeof(rtc_state.ip));
+  seal();
+}
+
+void SleepCycle::recordConnected() {
+  connect_ms = max(millis(), 1UL);
+}
+
+void SleepCycle::recordScan(const std::vector<NetworkInfo>& networks) {
+  // Results arrive strongest first
+  rtc_state.scan_count = min(networks.size(), (size_t)WAKE_SCAN_SUMMARY);
+  rtc_state.scan_total = min(networks.size(), (size_t)UINT16_MAX);
+  for (uint8_t i = 0; i < rtc_state.scan_count; i++) {
+    rtc_state.scan[i] = networks[i];
+  }
+  seal();
+}
+
+uint8_t SleepCycle::getScanCount() const {
+  return rtc_state.scan_count;
+}
+
+const NetworkInfo* SleepCycle::getScan() const {
+  return rtc_state.scan;
+}
+
+uint16_t SleepCycle::getScanTotal() const {
+  return rtc_state.scan_total;
+}
+
+void SleepCycle::sleep(uint32_t seconds) {
+  // millis() restarts from zero on every wake, so it is this cycle's awake time
+  uint32_t awake = max(millis(), 1UL);
+  rtc_state.last_awake_ms = awake;
+  rtc_state.last_connect_ms = connect_ms;
+  rtc_state.total_awake_ms += awake;
+  seal();
+  sleep_seconds = seconds;
+
+  Serial.printf("Awake %lu ms (online after %lu ms), sleeping %lu s\n",
+                (unsigned long)awake, (unsigned long)connect_ms, (unsigned long)seconds);
+
+#ifdef ARDUINO_ARCH_ESP32
+  Serial.flush();
+  esp_sleep_enable_timer_wakeup((uint64_t)seconds * 1000000ULL);
+  esp_deep_sleep_start();
+#endif
+}
+
+uint32_t SleepCycle::getWakeCount() const {
+  return rtc_state.wake_count;
+}
+
+uint32_t SleepCycle::getAwakeMs() const {
+  return millis();
+}
+
+uint32_t SleepCycle::getConnectMs() const {
+  return connect_ms;
+}
+
+uint32_t SleepCycle::getLastAwakeMs() const {
+  return rtc_state.last_awake_ms;
+}
+
+uint32_t SleepCycle::getLastConnectMs() const {
+  return rtc_state.last_connect_ms;
+}
+
+uint32_t SleepCycle::getTotalAwakeMs() const {
+  return rtc_state.total_awake_ms;
+}
+
+uint32_t SleepCycle::getSleepSeconds() const {
+  return sleep_seconds;
+}
@@ -0,0 +1,84 @@
+#ifndef SLEEPCYCLE_H
+#define SLEEPCYCLE_H
+
+#include <Arduino.h>
+#include <vector>
+#include "CredentialStore.h"
+#include "ConnectionEngine.h"
+#include "ScanCollector.h"
+#include "configs.h"
+
+#define WAKE_STATE_MAGIC 0x57414B45  // "WAKE"
+#define WAKE_STATE_VERSION 1
+#define WAKE_SCAN_SUMMARY 4          // Strongest networks kept from the last scan
+
+// What a wake needs to get back online, kept in RTC memory across deep sleep
+struct WakeState {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t scan_count;          // Entries in scan
+  uint16_t scan_total;         // Networks the last scan found
+  uint32_t wake_count;         // Wakes since power-on
+  SavedNetwork network;        // ssid "" = nothing to rejoin
+  StaticIp ip;                 // Last DHCP lease, reused as static config
+  NetworkInfo scan[WAKE_SCAN_SUMMARY];
+  uint32_t last_awake_ms;      // Previous cycle: boot to sleep
+  uint32_t last_connect_ms;    // Previous cycle: boot to got-IP (0 = offline)
+  uint32_t total_awake_ms;     // All cycles since power-on
+  uint32_t checksum;           // Over everything above
+};
+
+// Deep-sleep duty cycle: wake, do the work, sleep(). The network of the last
+// connection (credentials, BSSID, channel and its IP configuration) lives in
+// RTC memory, so a wake rejoins it without reading NVS, scanning or waiting
+// for DHCP. Every cycle records how long it stayed awake, which is what the
+// battery pays for, and the next wake reports it.
+class SleepCycle {
+private:
+  bool woke;                   // Timer wake with valid RTC state
+  uint32_t connect_ms;         // This cycle's boot to got-IP (0 = offline)
+  uint32_t sleep_seconds;      // Last sleep() request
+
+  static uint32_t checksumOf(const WakeState& state);
+  void seal();
+
+public:
+  // Constructor
+  SleepCycle();
+
+  // Validate the RTC state and report the previous cycle. True on a wake
+  // with usable state; a cold boot starts from a clean state.
+  bool begin();
+  bool isWake() const;
+
+  // Network to rejoin
+  bool hasNetwork() const;
+  const SavedNetwork& getNetwork() const;
+  const StaticIp* getStaticIp() const;   // nullptr without a stored lease
+  // Remember the network the station is connected to now
+  void recordConnection(const SavedNetwork& network);
+  // The stored network failed; the next cycle takes the full path
+  void forgetNetwork();
+  // Station got its IP: this cycle's wake-to-connected time
+  void recordConnected();
+
+  // Strongest networks of the last scan
+  void recordScan(const std::vector<NetworkInfo>& networks);
+  uint8_t getScanCount() const;
+  const NetworkInfo* getScan() const;
+  uint16_t getScanTotal() const;
+
+  // Record the awake time and deep-sleep (does not return on the device)
+  void sleep(uint32_t seconds = SLEEP_DURATION_SECONDS);
+
+  // Status methods
+  uint32_t getWakeCount() const;
+  uint32_t getAwakeMs() const;          // This cycle so far
+  uint32_t getConnectMs() const;
+  uint32_t getLastAwakeMs() const;      // Previous cycle
+  uint32_t getLastConnectMs() const;
+  uint32_t getTotalAwakeMs() const;
+  uint32_t getSleepSeconds() const;
+};
+
+#endif // SLEEPCYCLE_H
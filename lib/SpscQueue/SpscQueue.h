@@ -0,0 +1,71 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <utility>
+
+// Fixed-size ring buffer for exactly one producer task and one consumer task.
+// The producer only writes tail and the consumer only writes head, so no lock
+// is needed; acquire/release ordering publishes the slot contents with the
+// index. N must be a power of two. Producer and consumer may be the same task.
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+private:
+  T items[N];
+  std::atomic<uint32_t> head;  // Next slot to read (consumer)
+  std::atomic<uint32_t> tail;  // Next slot to write (producer)
+  std::atomic<uint32_t> dropped;
+
+public:
+  SpscQueue() : head(0), tail(0), dropped(0) {}
+
+  // Producer side. False (and counted) when the queue is full.
+  bool push(const T& item) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) >= N) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    items[t & (N - 1)] = item;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. False when the queue is empty.
+  bool pop(T& item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = std::move(items[h & (N - 1)]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: drain everything and keep only the newest item
+  bool popLatest(T& item) {
+    bool any = false;
+    while (pop(item)) {
+      any = true;
+    }
+    return any;
+  }
+
+  // Consumer side: discard everything queued so far
+  void clear() {
+    head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+  size_t size() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+  static constexpr size_t capacity() { return N; }
+  uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+#endif // SPSCQUEUE_H
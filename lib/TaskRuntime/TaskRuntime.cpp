@@ -0,0 +1,213 @@
+#include "TaskRuntime.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#define INPUT_TASK_PRIORITY 3
+#define RENDER_TASK_PRIORITY 2       // Raised from the loop task default
+#define NETWORK_TASK_PRIORITY 1
+#define INPUT_TASK_STACK 2048
+#define NETWORK_TASK_STACK 4096
+
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#define LIGHT_SLEEP_MIN_FREQ_MHZ 40  // XTAL clock while waiting
+#endif
+#endif
+
+TaskRuntime runtime;
+
+TaskRuntime::TaskRuntime() {
+  input_step = nullptr;
+  input_context = nullptr;
+  network_step = nullptr;
+  network_context = nullptr;
+  running = false;
+#ifdef ARDUINO_ARCH_ESP32
+  input_task = nullptr;
+#endif
+  frame_period = RENDER_PERIOD_MS;
+  next_frame = 0;
+  frame_requested = true;
+  resetStats();
+}
+
+void TaskRuntime::setInputStep(StepFunction step, void* context) {
+  input_step = step;
+  input_context = context;
+}
+
+void TaskRuntime::setNetworkStep(StepFunction step, void* context) {
+  network_step = step;
+  network_context = context;
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+void TaskRuntime::inputTask(void* arg) {
+  TaskRuntime* self = (TaskRuntime*)arg;
+  TickType_t last_wake = xTaskGetTickCount();
+  for (;;) {
+    self->input_step(self->input_context);
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(INPUT_PERIOD_MS));
+  }
+}
+
+void TaskRuntime::networkTask(void* arg) {
+  TaskRuntime* self = (TaskRuntime*)arg;
+  TickType_t last_wake = xTaskGetTickCount();
+  for (;;) {
+    self->network_step(self->network_context);
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(NETWORK_PERIOD_MS));
+  }
+}
+#endif
+
+bool TaskRuntime::begin() {
+  if (running || !input_step || !network_step) {
+    return running;
+  }
+
+#ifdef ARDUINO_ARCH_ESP32
+  if (xTaskCreate(inputTask, "input", INPUT_TASK_STACK, this, INPUT_TASK_PRIORITY, &input_task) != pdPASS) {
+    Serial.println("Failed to start input task");
+    input_task = nullptr;
+    return false;
+  }
+  if (xTaskCreate(networkTask, "network", NETWORK_TASK_STACK, this, NETWORK_TASK_PRIORITY, nullptr) != pdPASS) {
+    Serial.println("Failed to start network task");
+    // waitFrame() samples the controls inline from now on; a second
+    // producer on the input queue would break it
+    vTaskDelete(input_task);
+    input_task = nullptr;
+    return false;
+  }
+  vTaskPrioritySet(nullptr, RENDER_TASK_PRIORITY);
+  running = true;
+#endif
+
+  return running;
+}
+
+bool TaskRuntime::isRunning() const {
+  return running;
+}
+
+void TaskRuntime::setFrameRate(uint8_t fps) {
+  frame_period = fps > 0 ? max(1000 / fps, 1) : RENDER_PERIOD_MS;
+}
+
+uint8_t TaskRuntime::getFrameRate() const {
+  return 1000 / frame_period;
+}
+
+bool TaskRuntime::enableLightSleep() {
+#if defined(ARDUINO_ARCH_ESP32) && CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  // Automatic light sleep keeps the WiFi association, unlike
+  // esp_light_sleep_start(), and wakes for the next task deadline
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t config = {};
+#elif CONFIG_IDF_TARGET_ESP32C3
+  esp_pm_config_esp32c3_t config = {};
+#else
+  esp_pm_config_esp32_t config = {};
+#endif
+  config.max_freq_mhz = getCpuFrequencyMhz();
+  config.min_freq_mhz = LIGHT_SLEEP_MIN_FREQ_MHZ;
+  config.light_sleep_enable = true;
+  return esp_pm_configure(&config) == ESP_OK;
+#else
+  return false;
+#endif
+}
+
+// Single-task fallback: keep sampling input at its own rate until the frame
+void TaskRuntime::runInline(unsigned long until) {
+  do {
+    if (input_step) input_step(input_context);
+    if (network_step) network_step(network_context);
+
+    long remaining = (long)(until - millis());
+    if (remaining <= 0) {
+      break;
+    }
+    long step = min(remaining, (long)INPUT_PERIOD_MS);
+    delay(step);
+    idle_ms += step;
+  } while (true);
+}
+
+void TaskRuntime::waitFrame() {
+  unsigned long now = millis();
+  long late = (long)(now - next_frame);
+  if (frame_count == 0 || late > (long)frame_period || late < -(long)frame_period) {
+    // First frame, the UI stalled for more than a frame, or the grid is from
+    // an earlier run of the clock: restart it
+    if (frame_count > 0 && late > 0) overrun_count++;
+    next_frame = now;
+  }
+  next_frame += frame_period;
+  frame_count++;
+
+  if (running) {
+#ifdef ARDUINO_ARCH_ESP32
+    long remaining = (long)(next_frame - millis());
+    if (remaining > 0) {
+      vTaskDelay(pdMS_TO_TICKS(remaining));
+      idle_ms += remaining;
+    }
+#endif
+  } else {
+    runInline(next_frame);
+  }
+}
+
+void TaskRuntime::requestFrame() {
+  frame_requested = true;
+}
+
+bool TaskRuntime::frameDue() {
+  if (!frame_requested) {
+    skipped_count++;
+    return false;
+  }
+  frame_requested = false;
+  rendered_count++;
+  return true;
+}
+
+void TaskRuntime::recordInputLatency(uint32_t ms) {
+  if (ms > max_input_latency) {
+    max_input_latency = ms;
+  }
+}
+
+uint32_t TaskRuntime::getFrameCount() const {
+  return frame_count;
+}
+
+uint32_t TaskRuntime::getOverrunCount() const {
+  return overrun_count;
+}
+
+uint32_t TaskRuntime::getMaxInputLatency() const {
+  return max_input_latency;
+}
+
+uint32_t TaskRuntime::getRenderedCount() const {
+  return rendered_count;
+}
+
+uint32_t TaskRuntime::getSkippedCount() const {
+  return skipped_count;
+}
+
+uint32_t TaskRuntime::getIdleMs() const {
+  return idle_ms;
+}
+
+void TaskRuntime::resetStats() {
+  frame_count = 0;
+  overrun_count = 0;
+  max_input_latency = 0;
+  rendered_count = 0;
+  skipped_count = 0;
+  idle_ms = 0;
+}
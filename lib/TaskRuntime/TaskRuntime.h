@@ -0,0 +1,104 @@
+#ifndef TASKRUNTIME_H
+#define TASKRUNTIME_H
+
+#include <Arduino.h>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#define RENDER_PERIOD_MS 20          // 50 frames per second
+#define INPUT_PERIOD_MS 5            // Control sampling rate
+#define NETWORK_PERIOD_MS 10         // Scan/connect service rate
+
+// Runtime split into three tasks:
+//   input   - high priority, samples the controls every INPUT_PERIOD_MS
+//   network - runs scans and connects, never touches the display
+//   render  - the calling (Arduino loop) task, paced by waitFrame()
+// Tasks exchange data only through SpscQueue instances owned by the
+// producers and consumers. Until begin() succeeds (and always in the native
+// build) waitFrame() runs the input and network steps inline instead, so the
+// same UI code works with or without the scheduler.
+//
+// Frames are scheduled, not just paced: screens call requestFrame() when
+// something visible changed (input, a scroller step, network status) and
+// render only when frameDue() says so. Idle frames cost no drawing and no
+// bus traffic, and the render task waits out every deadline in the idle
+// task. Light sleep in those gaps needs enableLightSleep(), which only
+// succeeds with CONFIG_PM_ENABLE and tickless idle; the prebuilt Arduino
+// ESP32 core has neither, so by default idle frames only yield.
+class TaskRuntime {
+public:
+  typedef void (*StepFunction)(void* context);
+
+private:
+  StepFunction input_step;
+  void* input_context;
+  StepFunction network_step;
+  void* network_context;
+  bool running;
+#ifdef ARDUINO_ARCH_ESP32
+  TaskHandle_t input_task;     // Kept so a failed begin() can stop it again
+#endif
+
+  // Render pacing
+  uint16_t frame_period;       // ms
+  unsigned long next_frame;
+  bool frame_requested;
+  uint32_t frame_count;
+  uint32_t overrun_count;      // Frames that started late
+  uint32_t max_input_latency;  // Oldest input event seen by the UI (ms)
+  uint32_t rendered_count;     // frameDue() calls that returned true
+  uint32_t skipped_count;      // frameDue() calls with nothing to draw
+  uint32_t idle_ms;            // Time yielded between frames (not necessarily asleep)
+
+  void runInline(unsigned long until);
+
+#ifdef ARDUINO_ARCH_ESP32
+  static void inputTask(void* arg);
+  static void networkTask(void* arg);
+#endif
+
+public:
+  // Constructor
+  TaskRuntime();
+
+  void setInputStep(StepFunction step, void* context = nullptr);
+  void setNetworkStep(StepFunction step, void* context = nullptr);
+
+  // Start the input and network tasks (ESP32 only)
+  bool begin();
+  bool isRunning() const;
+
+  // Target frame rate (default 1000 / RENDER_PERIOD_MS)
+  void setFrameRate(uint8_t fps);
+  uint8_t getFrameRate() const;
+  // Let the idle task light-sleep between frames (needs CONFIG_PM_ENABLE and
+  // CONFIG_FREERTOS_USE_TICKLESS_IDLE in the SDK build; false and no change
+  // otherwise, as on the stock Arduino core)
+  bool enableLightSleep();
+
+  // Block until the next frame is due
+  void waitFrame();
+  // Something on screen changed; the next frameDue() returns true
+  void requestFrame();
+  // Whether this frame has anything to draw (call once per frame)
+  bool frameDue();
+
+  // Called by input consumers with the age of each event
+  void recordInputLatency(uint32_t ms);
+
+  // Status methods
+  uint32_t getFrameCount() const;
+  uint32_t getOverrunCount() const;
+  uint32_t getMaxInputLatency() const;
+  uint32_t getRenderedCount() const;
+  uint32_t getSkippedCount() const;
+  uint32_t getIdleMs() const;
+  void resetStats();
+};
+
+extern TaskRuntime runtime;
+
+#endif // TASKRUNTIME_H
@@ -0,0 +1,283 @@
+#include "TimeService.h"
+#include <time.h>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <sys/time.h>
+#endif
+
+#define TIME_STATE_MAGIC 0x54494D45  // "TIME"
+
+// Registers shared by both chips
+#define RTC_REG_SECONDS 0x00         // Seconds to year, BCD
+#define RTC_TIME_REGS 7
+#define DS1307_CLOCK_HALT 0x80       // Seconds register
+#define DS3231_REG_STATUS 0x0F
+#define DS3231_OSC_STOPPED 0x80      // Status register
+#define RTC_HOUR_12H 0x40            // Hours register: 12-hour mode
+#define RTC_HOUR_PM 0x20
+
+// Sync history; survives deep sleep (the RTC keeps the time itself)
+struct TimeState {
+  uint32_t magic;
+  uint32_t last_sync;          // Network time of the last sync
+  float drift_ppm;             // RTC fast (+) or slow (-) against network time
+  uint16_t drift_samples;
+};
+
+RTC_DATA_ATTR static TimeState rtc_time_state;
+
+static uint8_t toBcd(int value) {
+  return ((value / 10) << 4) | (value % 10);
+}
+
+static int fromBcd(uint8_t value) {
+  return (value >> 4) * 10 + (value & 0x0F);
+}
+
+TimeService::TimeService(TwoWire* twi, RtcChip rtc_chip) {
+  wire = twi;
+  chip = rtc_chip;
+  rtc_present = false;
+  time_valid = false;
+  base_epoch = 0;
+  base_millis = 0;
+  sync_interval_s = (uint32_t)TIME_SYNC_HOURS * 3600;
+  rtc_reads = 0;
+  network_syncs = 0;
+  last_error_s = 0;
+
+  if (rtc_time_state.magic != TIME_STATE_MAGIC) {
+    memset(&rtc_time_state, 0, sizeof(rtc_time_state));
+    rtc_time_state.magic = TIME_STATE_MAGIC;
+  }
+}
+
+bool TimeService::readRegisters(uint8_t reg, uint8_t* data, uint8_t count) {
+  wire->beginTransmission(RTC_I2C_ADDRESS);
+  wire->write(reg);
+  if (wire->endTransmission(false) != 0) {
+    return false;
+  }
+  if (wire->requestFrom((uint8_t)RTC_I2C_ADDRESS, (size_t)count) != count) {
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    data[i] = wire->read();
+  }
+  return true;
+}
+
+bool TimeService::writeRegisters(uint8_t reg, const uint8_t* data, uint8_t count) {
+  wire->beginTransmission(RTC_I2C_ADDRESS);
+  wire->write(reg);
+  wire->write(data, count);
+  return wire->endTransmission() == 0;
+}
+
+// Raw RTC time; false when the chip is missing or lost its time
+bool TimeService::readRtc(uint32_t& epoch) {
+  uint8_t regs[RTC_TIME_REGS];
+  if (!readRegisters(RTC_REG_SECONDS, regs, sizeof(regs))) {
+    return false;
+  }
+  rtc_reads++;
+
+  bool stopped = false;
+  if (chip == RTC_CHIP_DS1307) {
+    stopped = regs[0] & DS1307_CLOCK_HALT;
+  } else {
+    uint8_t status;
+    stopped = !readRegisters(DS3231_REG_STATUS, &status, 1) || (status & DS3231_OSC_STOPPED);
+  }
+
+  int hour;
+  if (regs[2] & RTC_HOUR_12H) {
+    hour = fromBcd(regs[2] & 0x1F) % 12 + ((regs[2] & RTC_HOUR_PM) ? 12 : 0);
+  } else {
+    hour = fromBcd(regs[2] & 0x3F);
+  }
+  epoch = toEpoch(2000 + fromBcd(regs[6]), fromBcd(regs[5] & 0x1F), fromBcd(regs[4]),
+                  hour, fromBcd(regs[1] & 0x7F), fromBcd(regs[0] & 0x7F));
+  return !stopped && epoch >= TIME_VALID_AFTER;
+}
+
+bool TimeService::writeRtc(uint32_t epoch) {
+  int year, month, day, hour, minute, second, weekday;
+  fromEpoch(epoch, year, month, day, hour, minute, second, weekday);
+
+  // 24-hour mode; a DS1307 starts running once the halt bit is clear
+  const uint8_t regs[RTC_TIME_REGS] = {
+    toBcd(second), toBcd(minute), toBcd(hour), (uint8_t)(weekday + 1),
+    toBcd(day), toBcd(month), toBcd(year % 100)
+  };
+  if (!writeRegisters(RTC_REG_SECONDS, regs, sizeof(regs))) {
+    return false;
+  }
+
+  if (chip == RTC_CHIP_DS3231) {
+    uint8_t status;
+    if (readRegisters(DS3231_REG_STATUS, &status, 1) && (status & DS3231_OSC_STOPPED)) {
+      status &= ~DS3231_OSC_STOPPED;
+      writeRegisters(DS3231_REG_STATUS, &status, 1);
+    }
+  }
+  return true;
+}
+
+uint32_t TimeService::correctDrift(uint32_t raw) const {
+  if (rtc_time_state.drift_samples == 0 || raw <= rtc_time_state.last_sync) {
+    return raw;
+  }
+  float elapsed = raw - rtc_time_state.last_sync;
+  return raw - (int32_t)lroundf(elapsed * rtc_time_state.drift_ppm / 1e6f);
+}
+
+void TimeService::setSystemTime(uint32_t epoch) {
+#ifdef ARDUINO_ARCH_ESP32
+  // time() and localtime() work before any network time arrives
+  struct timeval tv = {(time_t)epoch, 0};
+  settimeofday(&tv, nullptr);
+#else
+  (void)epoch;
+#endif
+}
+
+bool TimeService::begin() {
+  uint32_t raw;
+  rtc_present = false;
+  time_valid = false;
+
+  uint8_t probe;
+  if (!readRegisters(RTC_REG_SECONDS, &probe, 1)) {
+    Serial.println("No RTC found, time waits for the network");
+    return false;
+  }
+  rtc_present = true;
+
+  if (!readRtc(raw)) {
+    Serial.println("RTC lost its time, waiting for the network");
+    return false;
+  }
+
+  base_epoch = correctDrift(raw);
+  base_millis = millis();
+  time_valid = true;
+  setSystemTime(base_epoch);
+  return true;
+}
+
+bool TimeService::isValid() const {
+  return time_valid;
+}
+
+bool TimeService::hasRtc() const {
+  return rtc_present;
+}
+
+uint32_t TimeService::now() const {
+  if (!time_valid) {
+    return 0;
+  }
+  return base_epoch + (millis() - base_millis) / 1000;
+}
+
+void TimeService::setSyncInterval(uint32_t seconds) {
+  sync_interval_s = seconds;
+}
+
+bool TimeService::needsSync() const {
+  if (!time_valid || rtc_time_state.last_sync == 0) {
+    return true;
+  }
+  return now() - rtc_time_state.last_sync >= sync_interval_s;
+}
+
+bool TimeService::syncNetworkTime(uint32_t timeout_ms) {
+  configTime(0, 0, NTP_SERVER);
+  struct tm fields;
+  if (!getLocalTime(&fields, timeout_ms)) {
+    Serial.println("Network time unavailable");
+    return false;
+  }
+  uint32_t network = toEpoch(fields.tm_year + 1900, fields.tm_mon + 1, fields.tm_mday,
+                             fields.tm_hour, fields.tm_min, fields.tm_sec);
+
+  // How far the RTC ran off since it was last set
+  uint32_t raw;
+  if (rtc_present && readRtc(raw) && rtc_time_state.last_sync != 0 &&
+      network > rtc_time_state.last_sync) {
+    last_error_s = (int32_t)(raw - network);
+    uint32_t elapsed = network - rtc_time_state.last_sync;
+    if (elapsed >= TIME_DRIFT_MIN_S) {
+      float measured = last_error_s * 1e6f / elapsed;
+      TimeState& state = rtc_time_state;
+      state.drift_ppm = state.drift_samples == 0 ? measured : (state.drift_ppm + measured) / 2;
+      state.drift_samples++;
+    }
+  }
+
+  if (rtc_present && !writeRtc(network)) {
+    Serial.println("Failed to set the RTC");
+  }
+  rtc_time_state.last_sync = network;
+  base_epoch = network;
+  base_millis = millis();
+  time_valid = true;
+  setSystemTime(network);
+  network_syncs++;
+
+  Serial.printf("Network time synced, RTC off by %ld s, drift %.1f ppm\n",
+                (long)last_error_s, rtc_time_state.drift_ppm);
+  return true;
+}
+
+float TimeService::getDriftPpm() const {
+  return rtc_time_state.drift_ppm;
+}
+
+uint32_t TimeService::getLastSync() const {
+  return rtc_time_state.last_sync;
+}
+
+int32_t TimeService::getLastError() const {
+  return last_error_s;
+}
+
+uint32_t TimeService::getRtcReads() const {
+  return rtc_reads;
+}
+
+uint32_t TimeService::getNetworkSyncs() const {
+  return network_syncs;
+}
+
+// Days from 1970-01-01 by the civil-from-days algorithm (proleptic Gregorian)
+uint32_t TimeService::toEpoch(int year, int month, int day, int hour, int minute, int second) {
+  year -= month <= 2;
+  int era = year / 400;
+  int yoe = year - era * 400;
+  int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  int32_t days = era * 146097 + doe - 719468;
+  return (uint32_t)days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+void TimeService::fromEpoch(uint32_t epoch, int& year, int& month, int& day,
+                            int& hour, int& minute, int& second, int& weekday) {
+  uint32_t days = epoch / 86400;
+  uint32_t rest = epoch % 86400;
+  hour = rest / 3600;
+  minute = rest / 60 % 60;
+  second = rest % 60;
+  weekday = (days + 4) % 7;  // 1970-01-01 was a Thursday; 0 = Sunday
+
+  int32_t z = days + 719468;
+  int era = z / 146097;
+  int doe = z - era * 146097;
+  int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int mp = (5 * doy + 2) / 153;
+  day = doy - (153 * mp + 2) / 5 + 1;
+  month = mp < 10 ? mp + 3 : mp - 9;
+  year = yoe + era * 400 + (month <= 2);
+}
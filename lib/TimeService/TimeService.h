@@ -0,0 +1,83 @@
+#ifndef TIMESERVICE_H
+#define TIMESERVICE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "configs.h"
+
+#define RTC_I2C_ADDRESS 0x68         // DS3231 and DS1307
+#define TIME_VALID_AFTER 1704067200  // 2024-01-01: anything earlier was never set
+#define TIME_DRIFT_MIN_S 3600        // Shortest sync interval that measures drift
+
+#ifndef NTP_SERVER
+#define NTP_SERVER "pool.ntp.org"
+#endif
+
+enum RtcChip : uint8_t {
+  RTC_CHIP_DS3231,
+  RTC_CHIP_DS1307
+};
+
+// Wall-clock time from a battery-backed RTC, available at boot before WiFi.
+// begin() reads the chip once over the shared bus; now() runs from millis()
+// after that. Network time is only fetched when needsSync() says the
+// schedule is due (or the RTC has no valid time). Each sync writes the RTC
+// and measures how far it ran off since the previous one. That drift, in
+// ppm, corrects later reads.
+//
+// The bus is shared with the display: call begin() and syncNetworkTime()
+// with no frame transfer in flight (PartialDisplay::waitTransfer()).
+class TimeService {
+private:
+  TwoWire* wire;
+  RtcChip chip;
+  bool rtc_present;
+  bool time_valid;
+  uint32_t base_epoch;         // Corrected time at base_millis
+  unsigned long base_millis;
+  uint32_t sync_interval_s;
+
+  // Statistics
+  uint32_t rtc_reads;
+  uint32_t network_syncs;
+  int32_t last_error_s;        // RTC minus network time at the last sync
+
+  bool readRegisters(uint8_t reg, uint8_t* data, uint8_t count);
+  bool writeRegisters(uint8_t reg, const uint8_t* data, uint8_t count);
+  bool readRtc(uint32_t& epoch);
+  bool writeRtc(uint32_t epoch);
+  uint32_t correctDrift(uint32_t raw) const;
+  void setSystemTime(uint32_t epoch);
+
+public:
+  // Constructor
+  TimeService(TwoWire* twi = &Wire, RtcChip rtc_chip = RTC_CHIP_DS3231);
+
+  // Read the RTC; false without a chip or a valid time on it
+  bool begin();
+  bool isValid() const;
+  bool hasRtc() const;
+
+  // Seconds since the epoch (UTC); 0 until a valid time is known
+  uint32_t now() const;
+
+  // Network time schedule (default TIME_SYNC_HOURS)
+  void setSyncInterval(uint32_t seconds);
+  bool needsSync() const;
+  // Fetch network time (WiFi must be up), set the RTC and update the drift
+  bool syncNetworkTime(uint32_t timeout_ms = 5000);
+
+  // Status methods
+  float getDriftPpm() const;
+  uint32_t getLastSync() const;
+  int32_t getLastError() const;
+  uint32_t getRtcReads() const;
+  uint32_t getNetworkSyncs() const;
+
+  // Calendar conversion (UTC)
+  static uint32_t toEpoch(int year, int month, int day, int hour, int minute, int second);
+  static void fromEpoch(uint32_t epoch, int& year, int& month, int& day,
+                        int& hour, int& minute, int& second, int& weekday);
+};
+
+#endif // TIMESERVICE_H
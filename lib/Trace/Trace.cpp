@@ -0,0 +1,111 @@
+#include "Trace.h"
+
+static_assert((TRACE_EVENTS & (TRACE_EVENTS - 1)) == 0, "TRACE_EVENTS must be a power of two");
+static_assert(sizeof(TraceEvent) == 12, "TraceEvent is part of the dump format");
+
+static const char* const span_names[TRACE_SPAN_COUNT] = {
+  "none", "display", "scan", "connect", "keyboard", "scroll", "boot"
+};
+
+Tracer tracer;
+
+Tracer::Tracer() : next(0), start(0), enabled(true) {
+  for (uint32_t i = 0; i < TRACE_EVENTS; i++) {
+    slots[i].seq.store(0, std::memory_order_relaxed);
+  }
+}
+
+void IRAM_ATTR Tracer::record(uint8_t span, uint8_t phase, uint8_t arg) {
+  if (!enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots[index & (TRACE_EVENTS - 1)];
+  slot.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.event.cycles = ESP.getCycleCount();
+  slot.event.ms = millis();
+  slot.event.span = span;
+  slot.event.phase = phase;
+#ifdef ARDUINO_ARCH_ESP32
+  slot.event.core = xPortGetCoreID();
+#else
+  slot.event.core = 0;
+#endif
+  slot.event.arg = arg;
+  slot.seq.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::setEnabled(bool on) {
+  enabled.store(on, std::memory_order_relaxed);
+}
+
+bool Tracer::isEnabled() const {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+size_t Tracer::dump(Print& out) {
+  uint32_t last = next.load(std::memory_order_acquire);
+  uint32_t first = start.load(std::memory_order_relaxed);
+  uint32_t lost = 0;
+  if (last - first > TRACE_EVENTS) {
+    lost = last - first - TRACE_EVENTS;
+    first = last - TRACE_EVENTS;
+  }
+  uint16_t count = last - first;
+
+  uint32_t cpu_hz = ESP.getCpuFreqMHz() * 1000000UL;
+  size_t written = out.write((const uint8_t*)TRACE_DUMP_MAGIC, 4);
+  written += out.write((const uint8_t*)&cpu_hz, sizeof(cpu_hz));
+  written += out.write((const uint8_t*)&count, sizeof(count));
+  written += out.write((const uint8_t*)&lost, sizeof(lost));
+
+  uint8_t spans = TRACE_SPAN_COUNT - 1;
+  written += out.write(&spans, 1);
+  for (uint8_t span = 1; span < TRACE_SPAN_COUNT; span++) {
+    uint8_t length = strlen(span_names[span]);
+    written += out.write(&span, 1);
+    written += out.write(&length, 1);
+    written += out.write((const uint8_t*)span_names[span], length);
+  }
+
+  // Copy each slot between two reads of its sequence; a slot rewritten
+  // meanwhile goes out as span 0 so the count stays as announced
+  for (uint32_t index = first; index != last; index++) {
+    const Slot& slot = slots[index & (TRACE_EVENTS - 1)];
+    uint32_t before = slot.seq.load(std::memory_order_acquire);
+    TraceEvent event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (before != index + 1 || slot.seq.load(std::memory_order_relaxed) != before) {
+      memset(&event, 0, sizeof(event));
+    }
+    written += out.write((const uint8_t*)&event, sizeof(event));
+  }
+
+  start.store(last, std::memory_order_relaxed);
+  return written;
+}
+
+void Tracer::clear() {
+  start.store(next.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+const char* Tracer::spanName(uint8_t span) {
+  return span < TRACE_SPAN_COUNT ? span_names[span] : "unknown";
+}
+
+uint32_t Tracer::getRecorded() const {
+  return next.load(std::memory_order_relaxed);
+}
+
+uint32_t Tracer::getPending() const {
+  uint32_t pending = next.load(std::memory_order_relaxed) - start.load(std::memory_order_relaxed);
+  return min(pending, (uint32_t)TRACE_EVENTS);
+}
+
+uint32_t Tracer::getOverwritten() const {
+  uint32_t pending = next.load(std::memory_order_relaxed) - start.load(std::memory_order_relaxed);
+  return pending > TRACE_EVENTS ? pending - TRACE_EVENTS : 0;
+}
@@ -0,0 +1,98 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define TRACE_EVENTS 512             // Ring size, power of two (12 bytes each)
+#define TRACE_DUMP_MAGIC "TRC1"
+
+// Traced spans. Ids are part of the dump format; append only.
+enum TraceSpan : uint8_t {
+  TRACE_DISPLAY = 1,           // PartialDisplay::display()
+  TRACE_SCAN,                  // First scan pass started to last one collected
+  TRACE_CONNECT,               // WiFi.begin() to got-IP; end arg is the ConnectionState
+  TRACE_KEYBOARD,              // draw_keyboard()
+  TRACE_SCROLL,                // ScrollingText::update() steps
+  TRACE_BOOT,                  // Boot phase reached (instant); arg is the BootPhase
+  TRACE_SPAN_COUNT
+};
+
+enum TracePhase : uint8_t {
+  TRACE_BEGIN,
+  TRACE_END,
+  TRACE_INSTANT
+};
+
+// One event as stored and dumped (little-endian)
+struct TraceEvent {
+  uint32_t cycles;             // CPU cycle counter; wraps every ~18 s at 240 MHz
+  uint32_t ms;                 // millis(), lets the decoder unwrap cycles
+  uint8_t span;                // 0 = slot overwritten while it was dumped
+  uint8_t phase;
+  uint8_t core;
+  uint8_t arg;
+};
+
+// Flight recorder for hot-path timing. Any task (either core) records
+// begin/end events into a fixed ring with one atomic increment and no lock;
+// the oldest events are overwritten when it is full. Each slot carries a
+// sequence number written last, so dump() can run while tasks keep
+// recording and drops slots that were rewritten under it.
+//
+// Dump format: "TRC1", cpu Hz (u32), event count (u16), events overwritten
+// before the dump (u32), span count (u8), then per span its id (u8), name
+// length (u8) and name, then the events. trace_decode.py turns a capture
+// of it into per-span histograms and a Chrome trace.
+class Tracer {
+private:
+  struct Slot {
+    std::atomic<uint32_t> seq;   // Event index + 1 once written, 0 while writing
+    TraceEvent event;
+  };
+
+  Slot slots[TRACE_EVENTS];
+  std::atomic<uint32_t> next;    // Index of the next event
+  std::atomic<uint32_t> start;   // First event not yet dumped or cleared
+  std::atomic<bool> enabled;
+
+public:
+  // Constructor
+  Tracer();
+
+  void record(uint8_t span, uint8_t phase, uint8_t arg = 0);
+  void begin(uint8_t span) { record(span, TRACE_BEGIN); }
+  void end(uint8_t span, uint8_t arg = 0) { record(span, TRACE_END, arg); }
+
+  void setEnabled(bool on);
+  bool isEnabled() const;
+
+  // Write the events since the last dump or clear(); returns bytes written
+  size_t dump(Print& out);
+  void clear();
+
+  static const char* spanName(uint8_t span);
+
+  // Status methods
+  uint32_t getRecorded() const;         // Since power-on
+  uint32_t getPending() const;          // Kept for the next dump
+  uint32_t getOverwritten() const;      // Lost before they were dumped
+};
+
+extern Tracer tracer;
+
+// Begin/end pair around a block
+class TraceScope {
+private:
+  uint8_t span;
+
+public:
+  explicit TraceScope(uint8_t traced) : span(traced) { tracer.begin(span); }
+  ~TraceScope() { tracer.end(span); }
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(span) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(span)
+
+#endif // TRACE_H
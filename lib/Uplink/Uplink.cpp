@@ -0,0 +1,156 @@
+#include "Uplink.h"
+
+#define UPLINK_QUEUE_MAGIC 0x55504C4B  // "UPLK"
+
+// Ring of readings; survives deep sleep, zeroed on power-on
+struct UplinkQueue {
+  uint32_t magic;
+  uint16_t head;               // Oldest reading
+  uint16_t count;
+  uint32_t dropped;
+  Reading readings[UPLINK_QUEUE_MAX];
+};
+
+RTC_DATA_ATTR static UplinkQueue rtc_queue;
+
+Uplink::Uplink(const char* endpoint) : url(endpoint) {
+  attempts = 0;
+  next_attempt = 0;
+  resetStats();
+
+  if (rtc_queue.magic != UPLINK_QUEUE_MAGIC || rtc_queue.head >= UPLINK_QUEUE_MAX ||
+      rtc_queue.count > UPLINK_QUEUE_MAX) {
+    clear();
+  }
+}
+
+bool Uplink::add(uint32_t time, uint16_t sensor, int32_t value) {
+  bool kept_all = true;
+  if (rtc_queue.count == UPLINK_QUEUE_MAX) {
+    rtc_queue.head = (rtc_queue.head + 1) % UPLINK_QUEUE_MAX;
+    rtc_queue.count--;
+    rtc_queue.dropped++;
+    kept_all = false;
+  }
+
+  Reading& reading = rtc_queue.readings[(rtc_queue.head + rtc_queue.count) % UPLINK_QUEUE_MAX];
+  reading.time = time;
+  reading.sensor = sensor;
+  reading.value = value;
+  rtc_queue.count++;
+  return kept_all;
+}
+
+uint16_t Uplink::pending() const {
+  return rtc_queue.count;
+}
+
+void Uplink::clear() {
+  memset(&rtc_queue, 0, sizeof(rtc_queue));
+  rtc_queue.magic = UPLINK_QUEUE_MAGIC;
+}
+
+// Rows for the oldest count readings; returns the body length
+size_t Uplink::buildBatch(uint16_t count) {
+  uint32_t base = rtc_queue.readings[rtc_queue.head].time;
+  size_t length = snprintf(body, sizeof(body), "v1,%lu\n", (unsigned long)base);
+
+  for (uint16_t i = 0; i < count; i++) {
+    const Reading& reading = rtc_queue.readings[(rtc_queue.head + i) % UPLINK_QUEUE_MAX];
+    length += snprintf(body + length, sizeof(body) - length, "%ld,%u,%ld\n",
+                       (long)(int32_t)(reading.time - base), (unsigned)reading.sensor,
+                       (long)reading.value);
+  }
+  return length;
+}
+
+bool Uplink::service() {
+  if (rtc_queue.count == 0 || (long)(millis() - next_attempt) < 0) {
+    return false;
+  }
+
+  uint16_t count = min(rtc_queue.count, (uint16_t)UPLINK_BATCH_MAX);
+  size_t length = buildBatch(count);
+
+  http.setReuse(true);
+  http.setTimeout(UPLINK_TIMEOUT_MS);
+  http.begin(url);
+  http.addHeader("Content-Type", "text/csv");
+  last_status = http.POST((uint8_t*)body, length);
+  http.end();
+
+  request_count++;
+  if (last_status < 200 || last_status >= 300) {
+    // 250, 500, 1000 ms ...
+    failure_count++;
+    next_attempt = millis() + ((unsigned long)UPLINK_BACKOFF_MS << min(attempts, (uint8_t)8));
+    attempts++;
+    return false;
+  }
+
+  rtc_queue.head = (rtc_queue.head + count) % UPLINK_QUEUE_MAX;
+  rtc_queue.count -= count;
+  attempts = 0;
+  sent_count += count;
+  bytes_sent += length;
+  return true;
+}
+
+bool Uplink::flush(uint32_t timeout_ms) {
+  unsigned long start = millis();
+  attempts = 0;
+  next_attempt = start;
+
+  while (rtc_queue.count > 0) {
+    if (attempts >= UPLINK_MAX_ATTEMPTS) {
+      return false;
+    }
+
+    long wait = (long)(next_attempt - millis());
+    if (wait > 0) {
+      if (millis() - start + wait > timeout_ms) {
+        return false;
+      }
+      delay(wait);
+    }
+    service();
+  }
+  return true;
+}
+
+void Uplink::close() {
+  http.setReuse(false);
+  http.end();
+}
+
+uint32_t Uplink::getRequestCount() const {
+  return request_count;
+}
+
+uint32_t Uplink::getFailureCount() const {
+  return failure_count;
+}
+
+uint32_t Uplink::getSentCount() const {
+  return sent_count;
+}
+
+uint32_t Uplink::getBytesSent() const {
+  return bytes_sent;
+}
+
+uint32_t Uplink::getDroppedCount() const {
+  return rtc_queue.dropped;
+}
+
+int Uplink::getLastStatus() const {
+  return last_status;
+}
+
+void Uplink::resetStats() {
+  request_count = 0;
+  failure_count = 0;
+  sent_count = 0;
+  bytes_sent = 0;
+  last_status = 0;
+}
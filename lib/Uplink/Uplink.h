@@ -0,0 +1,79 @@
+#ifndef UPLINK_H
+#define UPLINK_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+#define UPLINK_QUEUE_MAX 96          // Readings kept across sleeps (RTC memory)
+#define UPLINK_BATCH_MAX 48          // Readings per POST
+#define UPLINK_MAX_ATTEMPTS 4        // Failed POSTs before flush() gives up
+#define UPLINK_BACKOFF_MS 250        // First retry delay, doubled after each failure
+#define UPLINK_TIMEOUT_MS 3000       // HTTP connect and response timeout
+#define UPLINK_ROW_MAX 30            // "-2147483648,65535,-2147483648\n"
+#define UPLINK_HEADER_MAX 16         // "v1,4294967295\n"
+
+// One measurement. The time is the caller's (epoch seconds, or any
+// monotonic count), sent relative to the first reading of the batch.
+struct Reading {
+  uint32_t time;
+  uint16_t sensor;
+  int32_t value;
+};
+
+// Telemetry uplink that sends readings in batches. Readings queue in RTC
+// memory, so the ones a wake could not deliver go out on a later one. Each
+// POST carries up to UPLINK_BATCH_MAX readings as delimited rows:
+//
+//   v1,<time of the first reading>\n
+//   <time delta>,<sensor>,<value>\n ...
+//
+// and goes over one keep-alive connection that stays open between batches.
+// Readings leave the queue only when the server answers 2xx; failures are
+// retried with exponential backoff. There is one queue per firmware.
+class Uplink {
+private:
+  String url;
+  HTTPClient http;
+  char body[UPLINK_HEADER_MAX + UPLINK_BATCH_MAX * UPLINK_ROW_MAX];
+
+  // Retry state of the current flush
+  uint8_t attempts;            // Failures since the last success
+  unsigned long next_attempt;
+
+  // Statistics
+  uint32_t request_count;
+  uint32_t failure_count;
+  uint32_t sent_count;         // Readings the server accepted
+  uint32_t bytes_sent;         // Request bodies
+  int last_status;
+
+  size_t buildBatch(uint16_t count);
+
+public:
+  // Constructor
+  explicit Uplink(const char* endpoint);
+
+  // Queue a reading; when the queue is full the oldest one is dropped
+  bool add(uint32_t time, uint16_t sensor, int32_t value);
+  uint16_t pending() const;
+  void clear();
+
+  // Send one batch if the backoff allows it; true when a batch was accepted
+  bool service();
+  // Send everything queued, retrying with backoff for up to timeout_ms.
+  // False if readings are left for a later wake.
+  bool flush(uint32_t timeout_ms = UPLINK_TIMEOUT_MS * 2);
+  // Close the kept-alive connection
+  void close();
+
+  // Status methods
+  uint32_t getRequestCount() const;
+  uint32_t getFailureCount() const;
+  uint32_t getSentCount() const;
+  uint32_t getBytesSent() const;
+  uint32_t getDroppedCount() const;     // Since power-on
+  int getLastStatus() const;
+  void resetStats();
+};
+
+#endif // UPLINK_H
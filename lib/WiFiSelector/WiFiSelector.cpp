@@ -1,41 +1,57 @@
 #include "WiFiSelector.h"
 #include "KeyInput.h"
+#include "TaskRuntime.h"
+#include "Trace.h"
 #include "configs.h"
 
-WiFiSelector::WiFiSelector(Adafruit_SSD1306* disp, Preferences* pref, const String& namespace_name, int timeout) {
+WiFiSelector::WiFiSelector(PartialDisplay* disp, Preferences* pref, const String& namespace_name, int timeout)
+  : list_view(disp), credentials(pref, namespace_name), keyboard(password_input, sizeof(password_input)) {
   display = disp;
   preferences = pref;
   pref_namespace = namespace_name;
   connection_timeout = timeout;
   
-  // Configure SSID scroller for 18 characters max display, smooth scrolling
-  ssid_scroller.setDisplayWidth(18, 108);  // 18 chars * 6 pixels = 108 pixels
-  ssid_scroller.enableSmoothScroll(true, 6);  // 6 pixels per character
-  ssid_scroller.setScrollDelay(100);  // Fast smooth scrolling
-  ssid_scroller.setPauseDelay(1500);  // 1.5 second pause at start/end
+  scan_pass = 0;
+  scan_pass_count = 0;
+  scan_found = 0;
+  scan_active = false;
+  connect_pending = false;
+  commands_done = 0;
+  status_dirty = false;
+  
+  commands_sent = 0;
+  spinner_frame = 0;
+  fast_ssid[0] = '\0';
+  fast_saved = nullptr;
+  memset(&status, 0, sizeof(status));
+  status.conn_state = CONN_IDLE;
+  scan_results.reserve(SCAN_TOP_K);
+  
 }
 
 void WiFiSelector::setConnectionTimeout(int timeout_ms) {
   connection_timeout = timeout_ms;
 }
 
-bool WiFiSelector::needsPassword(wifi_auth_mode_t enc_type) {
+bool WiFiSelector::needsPassword(uint8_t enc_type) {
   return (enc_type != WIFI_AUTH_OPEN);
 }
 
+// Channels scanned when the config does not name any
+static const uint8_t all_channels[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+
 std::vector<NetworkInfo> WiFiSelector::scanNetworks() {
-  display->clearDisplay();
-  display->setTextSize(1);
-  display->setTextColor(SSD1306_WHITE);
-  display->setCursor(0, 0);
-  display->println("WiFi Selector");
-  display->println("Scanning networks...");
-  display->display();
+  return scanNetworks(ScanConfig());
+}
+
+std::vector<NetworkInfo> WiFiSelector::scanNetworks(const ScanConfig& config) {
+  if (!startScan(config)) {
+    Serial.println("Failed to start scan");
+  }
   
-  int networkCount = WiFi.scanNetworks();
-  std::vector<NetworkInfo> networks;
+  std::vector<NetworkInfo> networks = waitForScan();
   
-  if (networkCount == 0) {
+  if (networks.empty()) {
     Serial.println("No networks found");
     
     display->clearDisplay();
@@ -48,185 +64,495 @@ std::vector<NetworkInfo> WiFiSelector::scanNetworks() {
     return networks;
   }
   
-  Serial.printf("Found %d networks\n", networkCount);
+  Serial.printf("Found %d networks\n", (int)networks.size());
+  return networks;
+}
+
+// ========================================
+// UI side: commands out, snapshots and results in
+// ========================================
+
+void WiFiSelector::sendCommand(const NetCommand& command) {
+  // Count first: the network task may answer before push() returns
+  commands_sent++;
+  while (!net_commands.push(command)) {
+    runtime.waitFrame();  // Let the network task catch up
+  }
+}
+
+bool WiFiSelector::startScan(const ScanConfig& config) {
+  NetCommand command = {};
+  command.type = NET_SCAN;
+  command.scan = config;
+  if (!command.scan.channels || command.scan.channel_count == 0) {
+    command.scan.channels = all_channels;
+    command.scan.channel_count = sizeof(all_channels);
+  }
+  
+  collector.clear();
+  collector.setLimit(command.scan.max_results);
+  scan_results.clear();
+  spinner_frame = 0;
+  sendCommand(command);
+  
+  // Assume the scan is running until the network task reports otherwise
+  status.scanning = true;
+  status.scan_pass = 0;
+  status.scan_pass_count = command.scan.channel_count;
+  status.scan_channel = command.scan.channels[0];
+  syncNetwork();
+  return true;
+}
+
+void WiFiSelector::startConnect(const char* ssid, const char* password, uint32_t timeout_ms,
+                                uint8_t channel, const uint8_t* bssid, const StaticIp* static_ip) {
+  NetCommand command = {};
+  command.type = NET_CONNECT;
+  strncpy(command.ssid, ssid, sizeof(command.ssid) - 1);
+  if (password) {
+    strncpy(command.password, password, sizeof(command.password) - 1);
+  }
+  if (bssid && channel) {
+    memcpy(command.bssid, bssid, sizeof(command.bssid));
+    command.channel = channel;
+  }
+  if (static_ip) {
+    command.static_ip = *static_ip;
+  }
+  command.timeout_ms = timeout_ms;
+  
+  sendCommand(command);
+  status.conn_state = CONN_CONNECTING;
+}
+
+int WiFiSelector::syncNetwork() {
+  if (!runtime.isRunning()) {
+    serviceNetwork();
+  }
+  
+  // Snapshots older than the last command describe superseded work
+  NetStatus latest;
+  if (net_status.popLatest(latest) && latest.commands_done == commands_sent) {
+    if (memcmp(&latest, &status, sizeof(status)) != 0) {
+      runtime.requestFrame();
+    }
+    status = latest;
+  }
+  
+  // Read after the snapshot: results are queued before the status reporting them
+  int changed = 0;
+  NetworkInfo network;
+  while (net_results.pop(network)) {
+    if (collector.add(network)) {
+      changed++;
+    }
+  }
+  if (changed > 0) {
+    collector.sortedInto(scan_results);
+    runtime.requestFrame();
+  }
+  return changed;
+}
+
+int WiFiSelector::pollScan() {
+  return syncNetwork();
+}
+
+bool WiFiSelector::isScanning() const {
+  return status.scanning;
+}
+
+int WiFiSelector::getScanProgress() const {
+  if (status.scan_pass_count == 0) {
+    return 100;
+  }
+  return status.scan_pass * 100 / status.scan_pass_count;
+}
+
+const std::vector<NetworkInfo>& WiFiSelector::getScanResults() const {
+  return scan_results;
+}
+
+const ScanCollector& WiFiSelector::getScanCollector() const {
+  return collector;
+}
+
+std::vector<NetworkInfo> WiFiSelector::waitForScan(bool first_results_only) {
+  while (isScanning()) {
+    pollScan();
+    if (first_results_only && !scan_results.empty()) {
+      break;
+    }
+    drawScanProgress();
+    runtime.waitFrame();
+  }
+  return scan_results;
+}
+
+void WiFiSelector::drawScanProgress() {
+  static const char spinner[] = {'|', '/', '-', '\\'};
+  
+  display->clearDisplay();
+  display->setTextSize(1);
+  display->setTextColor(SSD1306_WHITE);
+  display->setCursor(0, 0);
+  display->println("WiFi Selector");
+  display->print("Scanning networks ");
+  display->print(spinner[(spinner_frame++ / 5) % 4]);
+  
+  // Progress bar over completed passes
+  int bar_width = (SCREEN_WIDTH - 4) * getScanProgress() / 100;
+  display->drawRect(0, 24, SCREEN_WIDTH, 8, SSD1306_WHITE);
+  display->fillRect(2, 26, bar_width, 4, SSD1306_WHITE);
+  
+  display->setCursor(0, 40);
+  display->print("Channel ");
+  display->print(status.scan_channel);
+  display->print("  Found ");
+  display->print((int)scan_results.size());
+  display->display();
+}
+
+// ========================================
+// Network task side: owns the radio
+// ========================================
+
+void WiFiSelector::networkStep(void* selector) {
+  ((WiFiSelector*)selector)->serviceNetwork();
+}
+
+void WiFiSelector::serviceNetwork() {
+  NetCommand command;
+  while (net_commands.pop(command)) {
+    commands_done++;
+    status_dirty = true;
+    
+    switch (command.type) {
+      case NET_SCAN:
+        startScanWork(command.scan);
+        break;
+      case NET_CONNECT:
+        if (scan_active) {
+          // The radio cannot associate mid-scan; finish the current pass only
+          scan_pass_count = scan_pass + 1;
+          pending_connect = command;
+          connect_pending = true;
+        } else {
+          startConnectWork(command);
+        }
+        break;
+      case NET_CANCEL:
+        connect_pending = false;
+        connection.cancel();
+        break;
+    }
+  }
+  
+  if (scan_active) {
+    int16_t count = WiFi.scanComplete();
+    if (count != WIFI_SCAN_RUNNING) {
+      // A failed pass just contributes nothing; the driver's list is freed
+      // as soon as it has been copied
+      collectScanPass(count > 0 ? count : 0);
+      WiFi.scanDelete();
+      
+      scan_pass++;
+      if (scan_pass >= scan_pass_count || !startScanPass()) {
+        scan_active = false;
+        tracer.end(TRACE_SCAN, min(scan_found, 255));
+      }
+      status_dirty = true;
+    }
+  }
+  
+  if (connect_pending && !scan_active) {
+    connect_pending = false;
+    startConnectWork(pending_connect);
+  }
+  
+  ConnectionState before = connection.getState();
+  if (connection.poll() != before) {
+    status_dirty = true;
+  }
   
-  for (int i = 0; i < networkCount; i++) {
+  if (status_dirty) {
+    publishStatus();
+  }
+}
+
+void WiFiSelector::startScanWork(const ScanConfig& config) {
+  scan_config = config;
+  scan_pass = 0;
+  scan_pass_count = scan_config.channel_count;
+  scan_found = 0;
+  scan_active = startScanPass();
+  if (scan_active) {
+    tracer.begin(TRACE_SCAN);
+  }
+}
+
+bool WiFiSelector::startScanPass() {
+  uint8_t channel = scan_config.channels[scan_pass];
+  int16_t result = WiFi.scanNetworks(true, scan_config.show_hidden, scan_config.passive,
+                                     scan_config.dwell_ms, channel);
+  return result == WIFI_SCAN_RUNNING;
+}
+
+// Copied straight from the driver's records: no String per access point
+int WiFiSelector::collectScanPass(int count) {
+  for (int i = 0; i < count; i++) {
+    const wifi_ap_record_t* record = (const wifi_ap_record_t*)WiFi.getScanInfoByIndex(i);
+    if (!record) {
+      continue;
+    }
+    
     NetworkInfo network;
-    network.ssid = WiFi.SSID(i);
-    network.rssi = WiFi.RSSI(i);
-    network.encryption = WiFi.encryptionType(i);
+    memcpy(network.ssid, record->ssid, sizeof(network.ssid) - 1);
+    network.ssid[sizeof(network.ssid) - 1] = '\0';
+    memcpy(network.bssid, record->bssid, sizeof(network.bssid));
+    network.channel = record->primary;
+    network.rssi = record->rssi;
+    network.encryption = record->authmode;
     
-    networks.push_back(network);
+    if (!net_results.push(network)) {
+      continue;  // UI fell behind; counted by the queue
+    }
     
     Serial.printf("%d: %s (%d dBm) %s\n", 
-                  i + 1, 
-                  network.ssid.c_str(), 
+                  ++scan_found, 
+                  network.ssid, 
                   network.rssi, 
-                  encryptionTypeToString(network.encryption).c_str());
+                  encryptionName(network.encryption));
   }
+  return count;
+}
+
+void WiFiSelector::startConnectWork(const NetCommand& command) {
+  connection.connect(command.ssid, command.password, command.timeout_ms,
+                     command.channel, command.channel ? command.bssid : nullptr,
+                     command.static_ip.ip ? &command.static_ip : nullptr);
+}
+
+void WiFiSelector::publishStatus() {
+  NetStatus snapshot;
+  snapshot.commands_done = commands_done;
+  snapshot.scanning = scan_active;
+  snapshot.scan_pass = scan_pass;
+  snapshot.scan_pass_count = scan_pass_count;
+  snapshot.scan_channel = scan_config.channels ?
+    scan_config.channels[scan_pass < scan_pass_count ? scan_pass : scan_pass_count - 1] : 0;
+  snapshot.conn_state = connect_pending ? CONN_CONNECTING : connection.getState();
+  snapshot.disconnect_reason = connection.getDisconnectReason();
+  snapshot.conn_elapsed_ms = connection.getElapsedMs();
   
-  return networks;
+  // Retried on the next step if the UI has not drained the queue yet
+  if (net_status.push(snapshot)) {
+    status_dirty = false;
+  }
 }
 
-bool WiFiSelector::connectWithSavedCredentials(const std::vector<NetworkInfo>& networks) {
-  if (!preferences->begin(pref_namespace.c_str(), true)) {  // true = read-only
-    Serial.println("Failed to open preferences");
+bool WiFiSelector::hasSavedCredentials() {
+  return credentials.count() > 0;
+}
+
+CredentialStore& WiFiSelector::getCredentialStore() {
+  return credentials;
+}
+
+bool WiFiSelector::connectFast() {
+  return startFastConnect() && finishFastConnect();
+}
+
+bool WiFiSelector::connectFast(const SavedNetwork& network, const StaticIp* static_ip) {
+  return startFastConnect(network, static_ip) && finishFastConnect();
+}
+
+bool WiFiSelector::startFastConnect() {
+  const SavedNetwork* saved = credentials.mostRecent();
+  if (!saved || saved->channel == 0) {
+    Serial.println("No cached access point, scanning");
+    return false;
+  }
+  
+  if (!startFastConnect(*saved)) {
+    return false;
+  }
+  fast_saved = saved;
+  return true;
+}
+
+bool WiFiSelector::startFastConnect(const SavedNetwork& network, const StaticIp* static_ip) {
+  fast_saved = nullptr;
+  if (network.channel == 0) {
     return false;
   }
   
-  String saved_ssid = preferences->getString("ssid", "");
-  String saved_password = preferences->getString("password", "");
-  preferences->end();
+  Serial.printf("Fast reconnect: %s on channel %d%s\n", network.ssid, network.channel,
+                static_ip ? " with static IP" : "");
+  strncpy(fast_ssid, network.ssid, sizeof(fast_ssid) - 1);
+  fast_ssid[sizeof(fast_ssid) - 1] = '\0';
+  
+  startConnect(network.ssid, network.password, FAST_CONNECT_TIMEOUT_MS,
+               network.channel, network.bssid, static_ip);
+  syncNetwork();  // Without tasks, WiFi.begin() runs here rather than at the first wait
+  return true;
+}
+
+bool WiFiSelector::finishFastConnect() {
+  // Only worth a frame if the link is not already up
+  syncNetwork();
+  if (status.conn_state == CONN_CONNECTING) {
+    showConnectingScreen(fast_ssid);
+  }
+  
+  bool connected = waitForConnection();
+  if (connected) {
+    Serial.println("Connected to cached access point!");
+  }
   
-  if (saved_ssid.length() == 0) {
+  if (fast_saved) {
+    if (connected) {
+      credentials.recordSuccess(fast_saved->ssid, fast_saved->password, WiFi.BSSID(), WiFi.channel(), WiFi.RSSI());
+    } else {
+      // AP moved channel, was replaced or is out of range
+      Serial.println("Fast reconnect failed, falling back to scan");
+      credentials.clearHint(fast_saved->ssid);
+    }
+    fast_saved = nullptr;
+  }
+  return connected;
+}
+
+bool WiFiSelector::connectWithSavedCredentials(const std::vector<NetworkInfo>& networks) {
+  if (credentials.count() == 0) {
     Serial.println("No saved credentials found");
     return false;
   }
   
-  // Look for saved network in scan results
-  for (const NetworkInfo& network : networks) {
-    if (network.ssid.equals(saved_ssid)) {
-      Serial.println("Found saved network: " + saved_ssid);
-      
-      display->clearDisplay();
-      display->setCursor(0, 0);
-      display->println("Connecting to saved:");
-      display->println(saved_ssid);
-      display->display();
-      
-      if (needsPassword(network.encryption)) {
-        WiFi.begin(network.ssid, saved_password);
-      } else {
-        WiFi.begin(network.ssid);
-      }
-      
-      if (waitForConnection()) {
-        Serial.println("Connected to saved network!");
-        showConnectionResult(true, WiFi.localIP().toString());
-        return true;
-      } else {
-        Serial.println("Failed to connect to saved network");
-        WiFi.disconnect();
-        return false;
-      }
+  // One pass over the scan; each saved network is then a hash lookup
+  scan_set.clear();
+  for (size_t i = 0; i < networks.size(); i++) {
+    scan_set.add(networks[i].ssid, networks[i].rssi, i);
+  }
+  
+  Candidate candidates[CRED_STORE_MAX];
+  uint8_t found = credentials.rank(scan_set, candidates, CRED_STORE_MAX);
+  if (found == 0) {
+    Serial.println("Saved networks not found in scan");
+    return false;
+  }
+  
+  // Best score first; a failure demotes the network for next time
+  for (uint8_t i = 0; i < found; i++) {
+    const SavedNetwork* saved = credentials.get(candidates[i].record);
+    const NetworkInfo& network = networks[candidates[i].network];
+    Serial.printf("Found saved network: %s (score %d)\n", saved->ssid, candidates[i].score);
+    
+    display->clearDisplay();
+    display->setCursor(0, 0);
+    display->println("Connecting to saved:");
+    display->println(saved->ssid);
+    display->display();
+    
+    startConnect(saved->ssid, needsPassword(network.encryption) ? saved->password : nullptr,
+                 connection_timeout);
+    
+    if (waitForConnection()) {
+      Serial.println("Connected to saved network!");
+      credentials.recordSuccess(saved->ssid, saved->password, WiFi.BSSID(), WiFi.channel(), WiFi.RSSI());
+      showConnectionResult(true, WiFi.localIP().toString());
+      return true;
     }
+    
+    Serial.println("Failed to connect to saved network");
+    credentials.recordFailure(saved->ssid);
   }
   
-  Serial.println("Saved network not found in scan");
   return false;
 }
 
+void WiFiSelector::showNoNetworks() {
+  display->clearDisplay();
+  display->setCursor(0, 0);
+  display->println("No networks to");
+  display->println("select from!");
+  display->display();
+  delay(2000);
+}
+
 bool WiFiSelector::selectAndConnectNetwork(std::vector<NetworkInfo>& networks) {
-  if (networks.empty()) {
-    display->clearDisplay();
-    display->setCursor(0, 0);
-    display->println("No networks to");
-    display->println("select from!");
-    display->display();
-    delay(2000);
+  if (networks.empty() && !isScanning()) {
+    showNoNetworks();
     return false;
   }
   
   int selected_network = 0;
-  int total_networks = networks.size();
-  int last_selected = -1;  // Track when selection changes
   
   init_controls();  // Initialize potentiometers and button
+  flush_input();
+  
+  display->clearDisplay();
+  list_view.setNetworks(networks, isScanning());
+  list_view.setSelected(0);
+  list_view.invalidate();
+  runtime.requestFrame();
   
   while (true) {
-    // Update scrolling text when selection changes
-    if (selected_network != last_selected) {
-      ssid_scroller.setText(networks[selected_network].ssid);
-      last_selected = selected_network;
+    // Pick up networks from scan passes that finished in the background
+    if (isScanning()) {
+      // The list is re-sorted by signal; the highlight stays on its network
+      mergeScanResults(networks, &selected_network);
     }
-    
-    // Update scrolling animation
-    ssid_scroller.update();
-    
-    // Display current network
-    display->clearDisplay();
-    display->setTextSize(1);
-    display->setTextColor(SSD1306_WHITE);
-    display->setCursor(0, 0);
-    display->println("Select Network:");
-    
-    // Draw scrolling SSID with background clearing
-    display->setCursor(0, 16);
-    display->print("SSID: ");
-    ssid_scroller.drawWithBackground(display, 36, 16, 1, SSD1306_WHITE, SSD1306_BLACK);
-    
-    display->setCursor(0, 24);
-    display->print("Signal: ");
-    display->print(networks[selected_network].rssi);
-    display->println(" dBm");
-    
-    display->setCursor(0, 32);
-    display->print("Security: ");
-    if (needsPassword(networks[selected_network].encryption)) {
-      display->println("Protected");
-    } else {
-      display->println("Open");
+    if (networks.empty()) {
+      // The scan may have finished with nothing since the last frame
+      if (!isScanning()) {
+        showNoNetworks();
+        return false;
+      }
+      drawScanProgress();
+      list_view.invalidate();
+      runtime.requestFrame();
+      runtime.waitFrame();
+      continue;
     }
+    list_view.setNetworks(networks, isScanning());
+    list_view.setSelected(selected_network);
     
-    display->setCursor(0, 40);
-    display->print("Network ");
-    display->print(selected_network + 1);
-    display->print(" of ");
-    display->println(total_networks);
-    
-    display->setCursor(0, 48);
-    display->println("Y-Pot:nav Button:select");
-    
-    // Show scroll indicator if needed
-    if (ssid_scroller.needsScrolling()) {
-      display->setCursor(0, 56);
-      display->print("Scrolling...");
+    // Apply input queued since the last frame before drawing it
+    bool select_pressed = false;
+    InputEvent event;
+    while (!select_pressed && next_input(event)) {
+      if (event.type == NAV_UP) {
+        list_view.move(-1);
+        runtime.requestFrame();
+      } else if (event.type == NAV_DOWN) {
+        list_view.move(1);
+        runtime.requestFrame();
+      } else if (event.type == NAV_SELECT) {
+        select_pressed = true;
+      }
     }
+    selected_network = list_view.getSelected();
     
-    display->display();
-    
-    // Handle navigation with Y potentiometer
-    static unsigned long last_nav_time = 0;
-    if (millis() - last_nav_time > MOVE_DELAY) {
-      int y_move = get_y_movement();
-      if (y_move == -1) {
-        selected_network = (selected_network - 1 + total_networks) % total_networks;
-        last_nav_time = millis();
-      } else if (y_move == 1) {
-        selected_network = (selected_network + 1) % total_networks;
-        last_nav_time = millis();
-      }
+    // Nothing moved, arrived or changed: no drawing and no bus traffic
+    if (list_view.update()) {
+      runtime.requestFrame();
+    }
+    if (runtime.frameDue()) {
+      list_view.draw();  // Only the rows that changed are painted
     }
     
     // Handle selection with button
-    if (select_button_pressed()) {
-      NetworkInfo& network = networks[selected_network];
+    if (select_pressed) {
+      // Copy: late scan results may grow the list while the password is typed
+      NetworkInfo network = networks[selected_network];
       String password = "";
       
       if (needsPassword(network.encryption)) {
-        // Show password input screen
-        display->clearDisplay();
-        display->setCursor(0, 0);
-        display->println("Enter password for:");
-        
-        // Use scrolling text for password prompt too
-        ScrollingText password_prompt;
-        password_prompt.setText(network.ssid);
-        password_prompt.setDisplayWidth(21, 126);  // Almost full width
-        password_prompt.drawWithBackground(display, 0, 8, 1, SSD1306_WHITE, SSD1306_BLACK);
-        
-        display->display();
-        delay(1000);
-        
-        // Get password using keyboard
-        const char* entered_password = prompt_keyboard();
-        password = String(entered_password);
-        
-        WiFi.begin(network.ssid, password);
-      } else {
-        WiFi.begin(network.ssid);
+        password = promptPassword(network.ssid, networks);
       }
       
+      startConnect(network.ssid, password.c_str(), connection_timeout);
       showConnectingScreen(network.ssid);
       
       if (waitForConnection()) {
@@ -238,17 +564,83 @@ bool WiFiSelector::selectAndConnectNetwork(std::vector<NetworkInfo>& networks) {
         showConnectionResult(false);
         
         // Wait for button press to continue
-        while (!select_button_pressed()) {
-          delay(100);
+        flush_input();
+        while (!next_input(event) || event.type != NAV_SELECT) {
+          runtime.waitFrame();
         }
         
-        WiFi.disconnect();
         // Continue loop to try again
+        display->clearDisplay();
+        list_view.invalidate();
+        runtime.requestFrame();
       }
     }
     
-    delay(20);  // Reduced delay for smooth scrolling
+    runtime.waitFrame();  // Sleeps until the next frame deadline
+  }
+}
+
+// Take the collector's list after scan passes that finished since the last
+// call. selected, if given, is moved to wherever its network now sits.
+int WiFiSelector::mergeScanResults(std::vector<NetworkInfo>& networks, int* selected) {
+  if (!isScanning()) {
+    return 0;
+  }
+  int changed = pollScan();
+  if (changed == 0) {
+    return 0;
+  }
+  
+  char current[sizeof(NetworkInfo::ssid)] = "";
+  if (selected && *selected < (int)networks.size()) {
+    strcpy(current, networks[*selected].ssid);
+  }
+  networks = scan_results;  // Reuses the caller's storage once it has grown
+  
+  if (selected) {
+    *selected = 0;
+    for (size_t i = 0; i < networks.size(); i++) {
+      if (strcmp(networks[i].ssid, current) == 0) {
+        *selected = i;
+        break;
+      }
+    }
   }
+  return changed;
+}
+
+// The keyboard is polled once per frame, so the scan keeps filling the list
+// and the prompt keeps scrolling while the password is typed
+String WiFiSelector::promptPassword(const String& ssid, std::vector<NetworkInfo>& networks) {
+  // Show password input screen
+  display->clearDisplay();
+  display->setCursor(0, 0);
+  display->println("Enter password for:");
+  
+  // Use scrolling text for password prompt too
+  ScrollingText password_prompt;
+  password_prompt.setText(ssid);
+  password_prompt.setDisplayWidth(21, 126);  // Almost full width
+  
+  unsigned long shown = millis();
+  bool first = true;
+  while (millis() - shown < 1000) {
+    mergeScanResults(networks);
+    if (password_prompt.update() || first) {
+      password_prompt.drawWithBackground(display, 0, 8, 1, SSD1306_WHITE, SSD1306_BLACK);
+      display->display();
+      first = false;
+    }
+    runtime.waitFrame();
+  }
+  
+  // Get password using keyboard
+  keyboard.begin();
+  while (!keyboard.poll()) {
+    mergeScanResults(networks);
+    runtime.waitFrame();
+  }
+  return String(keyboard.result());
 }
 
 void WiFiSelector::showConnectingScreen(const String& ssid) {
@@ -270,6 +662,7 @@ void WiFiSelector::showConnectionResult(bool success, const String& ip) {
     display->println(ip);
   } else {
     display->println("Connection failed!");
+    display->println(ConnectionEngine::stateToString((ConnectionState)status.conn_state));
     display->println("Press button");
     display->println("to try again");
   }
@@ -279,53 +672,38 @@ void WiFiSelector::showConnectionResult(bool success, const String& ip) {
 }
 
 bool WiFiSelector::waitForConnection() {
-  unsigned long start_time = millis();
-  
-  while (WiFi.status() != WL_CONNECTED && millis() - start_time < connection_timeout) {
-    delay(500);
-    Serial.print(".");
+  // The network task settles the attempt from WiFi events; keep frames going
+  syncNetwork();
+  while (status.conn_state == CONN_CONNECTING) {
+    runtime.waitFrame();
+    syncNetwork();
   }
   
-  return (WiFi.status() == WL_CONNECTED);
+  Serial.printf("%s after %lu ms\n", ConnectionEngine::stateToString((ConnectionState)status.conn_state),
+                (unsigned long)status.conn_elapsed_ms);
+  return status.conn_state == CONN_CONNECTED;
 }
 
 void WiFiSelector::saveCredentials(const String& ssid, const String& password) {
-  if (!preferences->begin(pref_namespace.c_str(), false)) {  // false = read-write
-    Serial.println("Failed to open preferences for writing");
-    return;
-  }
-  
-  preferences->putString("ssid", ssid);
-  preferences->putString("password", password);
-  preferences->end();
-  
+  credentials.recordSuccess(ssid.c_str(), password.c_str(), WiFi.BSSID(), WiFi.channel(), WiFi.RSSI());
   Serial.println("Credentials saved: " + ssid);
 }
 
+// Static snapshot of the list: the strongest networks, nothing highlighted
 void WiFiSelector::displayNetworkList(const std::vector<NetworkInfo>& networks) {
   display->clearDisplay();
-  display->setTextSize(1);
-  display->setTextColor(SSD1306_WHITE);
-  display->setCursor(0, 0);
-  
-  display->printf("Found %d networks:\n", networks.size());
-  
-  int displayed = 0;
-  for (const auto& network : networks) {
-    if (displayed >= 6) break;  // Limit to screen space
-    
-    display->printf("%s (%d)\n", network.ssid.c_str(), network.rssi);
-    displayed++;
-  }
-  
-  if (networks.size() > 6) {
-    display->printf("...and %d more", networks.size() - 6);
-  }
-  
-  display->display();
+  list_view.setNetworks(networks, isScanning());
+  list_view.setSelected(0);
+  list_view.invalidate();
+  list_view.draw();
 }
 
 String WiFiSelector::encryptionTypeToString(wifi_auth_mode_t enc) {
+  return String(encryptionName(enc));
+}
+
+// Static text, so the scan log does not build a String per access point
+const char* WiFiSelector::encryptionName(uint8_t enc) {
   switch (enc) {
     case WIFI_AUTH_OPEN:
       return "Open";
@@ -347,9 +725,5 @@ String WiFiSelector::encryptionTypeToString(wifi_auth_mode_t enc) {
 }
 
 int WiFiSelector::getSignalStrength(int32_t rssi) {
-  if (rssi >= -50) return 4;      // Excellent
-  else if (rssi >= -60) return 3; // Good
-  else if (rssi >= -70) return 2; // Fair
-  else if (rssi >= -80) return 1; // Weak
-  else return 0;                  // Very weak
+  return signalBars(rssi);
 }
@@ -7,26 +7,125 @@
 #include <Adafruit_SSD1306.h>
 #include <Preferences.h>
 #include "ScrollingText.h"
+#include "PartialDisplay.h"
+#include "NetworkListView.h"
+#include "CredentialStore.h"
+#include "ConnectionEngine.h"
+#include "SpscQueue.h"
+#include "ScanCollector.h"
+#include "KeyInput.h"
 #include "configs.h"
 
-struct NetworkInfo {
-  String ssid;
-  int32_t rssi;
-  wifi_auth_mode_t encryption;
+// Give up on the cached BSSID/channel after this long and fall back to a scan
+#define FAST_CONNECT_TIMEOUT_MS 5000
+
+// Options for the asynchronous scanner. Channels are scanned one pass at a
+// time so results can be used as soon as the first pass completes.
+struct ScanConfig {
+  const uint8_t* channels;     // Channels to scan (nullptr = 1 to 13)
+  uint8_t channel_count;
+  uint32_t dwell_ms;           // Time spent listening on each channel
+  bool passive;
+  bool show_hidden;
+  uint8_t max_results;         // Strongest networks kept (up to SCAN_TOP_K)
+  
+  ScanConfig(const uint8_t* chans = nullptr, uint8_t count = 0, uint32_t dwell = 300)
+    : channels(chans), channel_count(count), dwell_ms(dwell), passive(false), show_hidden(false),
+      max_results(SCAN_TOP_K) {}
+};
+
+// Work handed from the UI to the network task
+enum NetCommandType : uint8_t {
+  NET_SCAN,
+  NET_CONNECT,
+  NET_CANCEL
+};
+
+struct NetCommand {
+  uint8_t type;
+  ScanConfig scan;             // NET_SCAN (the channel list must outlive the scan)
+  char ssid[33];               // NET_CONNECT
+  char password[64];
+  uint8_t bssid[6];
+  uint8_t channel;             // 0 = no BSSID/channel hint
+  StaticIp static_ip;          // ip 0 = DHCP
+  uint32_t timeout_ms;
+};
+
+// Network state published by the network task after every change
+struct NetStatus {
+  uint32_t commands_done;      // Commands processed when this was taken
+  bool scanning;
+  uint8_t scan_pass;
+  uint8_t scan_pass_count;
+  uint8_t scan_channel;
+  uint8_t conn_state;          // ConnectionState
+  uint8_t disconnect_reason;
+  uint32_t conn_elapsed_ms;
 };
 
 class WiFiSelector {
 private:
-  Adafruit_SSD1306* display;
+  PartialDisplay* display;
   Preferences* preferences;
   String pref_namespace;
   int connection_timeout;
   
-  // Scrolling text for SSID display
-  ScrollingText ssid_scroller;
+  // Network list with the scrolling SSID of the highlighted row
+  NetworkListView list_view;
+  
+  // Remembered networks and the scan lookup used to match them
+  CredentialStore credentials;
+  ScanSet scan_set;
+  
+  // Network task side: scan passes and the event-driven connection
+  ScanConfig scan_config;
+  uint8_t scan_pass;           // Passes completed
+  uint8_t scan_pass_count;     // Passes in this scan
+  int scan_found;
+  bool scan_active;
+  bool connect_pending;        // Connect waiting for the current pass to end
+  NetCommand pending_connect;
+  uint32_t commands_done;
+  bool status_dirty;           // Snapshot still to be published
+  ConnectionEngine connection;
+  
+  // Between the tasks; each queue has one producer and one consumer
+  SpscQueue<NetCommand, 4> net_commands;   // UI -> network
+  SpscQueue<NetworkInfo, 64> net_results;  // network -> UI
+  SpscQueue<NetStatus, 4> net_status;      // network -> UI
+  
+  // UI side: the collector keeps the strongest networks, scan_results is
+  // its sorted copy (reserved once)
+  ScanCollector collector;
+  std::vector<NetworkInfo> scan_results;
+  NetStatus status;            // Latest accepted snapshot
+  uint32_t commands_sent;
+  uint8_t spinner_frame;
+  
+  // Fast connect in flight: its SSID, and the NVS record when it came from there
+  char fast_ssid[33];
+  const SavedNetwork* fast_saved;
+  
+  // Password entry, polled between frames like everything else
+  char password_input[KEYINPUT_MAX_LENGTH + 1];
+  KeyInput keyboard;
   
   // Internal methods
-  bool needsPassword(wifi_auth_mode_t enc_type);
+  void sendCommand(const NetCommand& command);
+  void startConnect(const char* ssid, const char* password, uint32_t timeout_ms,
+                    uint8_t channel = 0, const uint8_t* bssid = nullptr,
+                    const StaticIp* static_ip = nullptr);
+  int syncNetwork();
+  int mergeScanResults(std::vector<NetworkInfo>& networks, int* selected = nullptr);
+  String promptPassword(const String& ssid, std::vector<NetworkInfo>& networks);
+  void startScanWork(const ScanConfig& config);
+  bool startScanPass();
+  int collectScanPass(int count);
+  void startConnectWork(const NetCommand& command);
+  void publishStatus();
+  bool needsPassword(uint8_t enc_type);
+  void showNoNetworks();
   void showConnectingScreen(const String& ssid);
   void showConnectionResult(bool success, const String& ip = "");
   bool waitForConnection();
@@ -34,19 +133,44 @@ private:
   
 public:
   // Constructor
-  WiFiSelector(Adafruit_SSD1306* disp, Preferences* pref, const String& namespace_name = "wifi-creds", int timeout = 10000);
+  WiFiSelector(PartialDisplay* disp, Preferences* pref, const String& namespace_name = "wifi-creds", int timeout = 10000);
   
   // Main public methods
+  bool connectFast();  // Saved network on its last BSSID and channel, no scan
+  // Same without touching NVS, for a network held elsewhere (RTC memory)
+  bool connectFast(const SavedNetwork& network, const StaticIp* static_ip = nullptr);
+  // connectFast() in two halves, so boot can bring up the display meanwhile
+  bool startFastConnect();
+  bool startFastConnect(const SavedNetwork& network, const StaticIp* static_ip = nullptr);
+  bool finishFastConnect();
   std::vector<NetworkInfo> scanNetworks();
+  std::vector<NetworkInfo> scanNetworks(const ScanConfig& config);
   bool connectWithSavedCredentials(const std::vector<NetworkInfo>& networks);
   bool selectAndConnectNetwork(std::vector<NetworkInfo>& networks);
   
+  // Asynchronous scanning
+  bool startScan(const ScanConfig& config = ScanConfig());
+  int pollScan();  // Returns results that changed the list since the last call
+  bool isScanning() const;
+  int getScanProgress() const;  // Percent of passes completed
+  const std::vector<NetworkInfo>& getScanResults() const;  // Strongest first
+  const ScanCollector& getScanCollector() const;
+  std::vector<NetworkInfo> waitForScan(bool first_results_only = false);
+  void drawScanProgress();
+  
+  // Network task step; everything that touches the radio runs here
+  void serviceNetwork();
+  static void networkStep(void* selector);
+  
   // Utility methods
+  bool hasSavedCredentials();
+  CredentialStore& getCredentialStore();
   void setConnectionTimeout(int timeout_ms);
   void displayNetworkList(const std::vector<NetworkInfo>& networks);
   
   // Static utility
   static String encryptionTypeToString(wifi_auth_mode_t enc);
+  static const char* encryptionName(uint8_t enc);
   static int getSignalStrength(int32_t rssi);
 };
 
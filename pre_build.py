@@ -20,6 +20,7 @@ def generate_config_h():
         'OLED_SDA_PIN': '8',
         'OLED_SCL_PIN': '9',
         'OLED_RESET_PIN': '-1',
+        'OLED_I2C_CLOCK_HZ': '400000',
         'SCREEN_WIDTH': '128',
         'SCREEN_HEIGHT': '64',
         'POT_X_PIN': '0',
@@ -30,7 +31,10 @@ def generate_config_h():
         'POT_SENSITIVITY': '3',
         'MOVE_DELAY': '150',
         'SLEEP_DURATION_SECONDS': '300',
-        'WIFI_TIMEOUT_MS': '15000'
+        'WIFI_TIMEOUT_MS': '15000',
+        'UPLINK_URL': 'http://192.168.1.10:8080/telemetry',
+        'TIME_SYNC_HOURS': '24',
+        'TRACE_DUMP': '0'
     }
     
     # Read .env.local if it exists
@@ -60,6 +64,7 @@ def generate_config_h():
 #define OLED_SDA_PIN ''' + config_values['OLED_SDA_PIN'] + '''
 #define OLED_SCL_PIN ''' + config_values['OLED_SCL_PIN'] + '''
 #define OLED_RESET_PIN ''' + config_values['OLED_RESET_PIN'] + '''
+#define OLED_I2C_CLOCK_HZ ''' + config_values['OLED_I2C_CLOCK_HZ'] + '''
 
 // Display Settings
 #define SCREEN_WIDTH ''' + config_values['SCREEN_WIDTH'] + '''
@@ -80,6 +85,15 @@ def generate_config_h():
 #define SLEEP_DURATION_SECONDS ''' + config_values['SLEEP_DURATION_SECONDS'] + '''
 #define WIFI_TIMEOUT_MS ''' + config_values['WIFI_TIMEOUT_MS'] + '''
 
+// Telemetry
+#define UPLINK_URL "''' + config_values['UPLINK_URL'] + '''"
+
+// Time
+#define TIME_SYNC_HOURS ''' + config_values['TIME_SYNC_HOURS'] + '''
+
+// Diagnostics
+#define TRACE_DUMP ''' + config_values['TRACE_DUMP'] + '''
+
 // Special Characters for KeyInput
 #define REMOVE_CHAR 127
 #define LEFT_CHAR 128
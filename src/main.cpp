@@ -3,58 +3,107 @@
 #include <string.h>
 #include <Adafruit_SSD1306.h>
 #include <Adafruit_GFX.h>
-#include <RTClib.h>
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <freertos/FreeRTOS.h>
 #include <Preferences.h>
 #include "KeyInput.h"
+#include "PartialDisplay.h"
 #include "WiFiSelector.h"
+#include "TaskRuntime.h"
+#include "SleepCycle.h"
+#include "Uplink.h"
+#include "TimeService.h"
+#include "Trace.h"
+#include "BootTimeline.h"
 #include "configs.h"
 
 // Global objects
 Preferences pref;
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET_PIN);
+PartialDisplay display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET_PIN);
 WiFiSelector wifiSelector(&display, &pref);
+SleepCycle sleepCycle;
+Uplink uplink(UPLINK_URL);
+TimeService timeService;
+BootTimeline bootTimeline;
+
+// Telemetry sensor ids
+enum TelemetrySensor : uint16_t {
+  SENSOR_AWAKE_MS = 1,         // Previous cycle, boot to sleep
+  SENSOR_CONNECT_MS,           // Previous cycle, boot to IP
+  SENSOR_RSSI,                 // This cycle's signal
+  SENSOR_BOOT_MS               // This cycle, reset to ready
+};
+
+// How the radio was started at boot
+enum BootRadio : uint8_t {
+  RADIO_WAKE_STATE,            // Network kept in RTC memory: no NVS, scan or DHCP
+  RADIO_FAST_RECONNECT,        // Last access point from NVS, no scan
+  RADIO_SCAN
+};
 
 // Global variables
 unsigned long globalmilisbuff_start;
 unsigned long globalmilisbuff_end;
 
 // function declaration
+BootRadio startRadio();
 void entrypoint();
+bool finishRadio(BootRadio& radio);
+bool connectWithScan();
+void goToSleep();
 
 void loop() {
-  // Main loop - can be used for other tasks after WiFi connection
+  // Not reached on the device: every cycle ends in deep sleep in setup()
   delay(1000);
 }
 
 
 void setup() {
-  entrypoint();
+  tracer.setEnabled(TRACE_DUMP);
+  bootTimeline.mark(BOOT_SETUP);
+  globalmilisbuff_start = millis();
+  bool woke = sleepCycle.begin();
   
-  // Scan for available networks
-  auto networks = wifiSelector.scanNetworks();
+  // The radio starts first; display, splash and RTC come up while the
+  // network task scans or associates
+  BootRadio radio = startRadio();
+  entrypoint();
+  if (woke) {
+    // Queued in RTC memory, sent once connected (now or on a later wake).
+    // Stamped with RTC time; 0 while no valid time is known.
+    uplink.add(timeService.now(), SENSOR_AWAKE_MS, sleepCycle.getLastAwakeMs());
+    uplink.add(timeService.now(), SENSOR_CONNECT_MS, sleepCycle.getLastConnectMs());
+  }
   
-  if (networks.empty()) {
-    Serial.println("No networks found, cannot proceed");
-    return;
+  if (!runtime.enableLightSleep()) {
+    Serial.println("Light sleep unavailable, idle frames only yield");
   }
   
-  // 1. Try to connect with previously saved credentials
-  if (!wifiSelector.connectWithSavedCredentials(networks)) {
-    // 2. If that fails, prompt user to select and connect to a network
-    if (wifiSelector.selectAndConnectNetwork(networks)) {
-      Serial.println("Successfully connected to selected network");
-    } else {
-      Serial.println("Failed to connect to any network");
-    }
-  } else {
-    Serial.println("Connected using saved credentials");
+  if (!finishRadio(radio)) {
+    bootTimeline.mark(BOOT_READY);
+    bootTimeline.report(Serial);
+    goToSleep();
+    return;
   }
+  static const char* const connect_paths[] = {"wake state", "fast reconnect", "scan"};
+  const char* connect_path = connect_paths[radio];
+  bool from_rtc = radio == RADIO_WAKE_STATE;
   
   // Continue with your main application logic here
   if (WiFi.status() == WL_CONNECTED) {
+    globalmilisbuff_end = millis();
+    bootTimeline.mark(BOOT_CONNECTED);
+    sleepCycle.recordConnected();
+    if (!from_rtc) {
+      const SavedNetwork* network = wifiSelector.getCredentialStore().mostRecent();
+      if (network) {
+        sleepCycle.recordConnection(*network);
+      }
+    }
+    Serial.printf("Boot to IP: %lu ms (%s, %lu ms in setup)\n",
+                  globalmilisbuff_end, connect_path, globalmilisbuff_end - globalmilisbuff_start);
+    
     Serial.println("WiFi setup complete!");
     Serial.print("IP Address: ");
     Serial.println(WiFi.localIP());
@@ -70,13 +119,134 @@ void setup() {
     display.println();
     display.println("Ready for operation");
     display.display();
+    bootTimeline.mark(BOOT_READY);
+    bootTimeline.report(Serial);
+    
+    // Network time only when the schedule is due or the RTC lost its time
+    if (timeService.needsSync()) {
+      display.waitTransfer();
+      timeService.syncNetworkTime();
+    }
+    
+    // One batched POST for everything queued since the last upload
+    uplink.add(timeService.now(), SENSOR_RSSI, WiFi.RSSI());
+    uplink.add(timeService.now(), SENSOR_BOOT_MS, bootTimeline.getReadyMs());
+    if (!uplink.flush()) {
+      Serial.printf("Uplink failed (%d), %u readings kept for the next wake\n",
+                    uplink.getLastStatus(), uplink.pending());
+    }
+    uplink.close();
+  } else {
+    bootTimeline.mark(BOOT_READY);
+    bootTimeline.report(Serial);
   }
+  
+  goToSleep();
 }
 
-void entrypoint(){
+// This cycle's work is done: panel off, then deep sleep until the next one
+void goToSleep() {
+  display.waitTransfer();
+  if (TRACE_DUMP) {
+    // This wake's spans, binary; decode the capture with trace_decode.py
+    tracer.dump(Serial);
+    Serial.flush();
+  }
+  display.ssd1306_command(SSD1306_DISPLAYOFF);
+  sleepCycle.sleep(SLEEP_DURATION_SECONDS);
+}
+
+// Serial and radio up, then the cheapest way online handed to the network
+// task; nothing here waits for the radio
+BootRadio startRadio() {
   Serial.begin(115200);
+  bootTimeline.mark(BOOT_SERIAL);
   WiFi.mode(WIFI_STA);
+  bootTimeline.mark(BOOT_RADIO_MODE);
+  
+  // Controls are sampled by the input task, radio work runs in the network task
+  init_controls();
+  runtime.setInputStep([](void*) { sample_controls(); });
+  runtime.setNetworkStep(WiFiSelector::networkStep, &wifiSelector);
+  runtime.begin();
   
+  // 1. After deep sleep, rejoin the network kept in RTC memory
+  // 2. Else the last access point when NVS has its channel
+  // 3. Else scan
+  BootRadio radio = RADIO_SCAN;
+  if (sleepCycle.hasNetwork() &&
+      wifiSelector.startFastConnect(sleepCycle.getNetwork(), sleepCycle.getStaticIp())) {
+    radio = RADIO_WAKE_STATE;
+  } else if (wifiSelector.startFastConnect()) {
+    radio = RADIO_FAST_RECONNECT;
+  } else {
+    wifiSelector.startScan();
+  }
+  bootTimeline.mark(BOOT_RADIO_STARTED);
+  return radio;
+}
+
+// Wait for what startRadio() began, falling back down the same order.
+// radio ends up as the path that got through; false if no network was found.
+bool finishRadio(BootRadio& radio) {
+  if (radio == RADIO_WAKE_STATE) {
+    if (wifiSelector.finishFastConnect()) {
+      return true;
+    }
+    sleepCycle.forgetNetwork();
+    radio = wifiSelector.startFastConnect() ? RADIO_FAST_RECONNECT : RADIO_SCAN;
+    if (radio == RADIO_SCAN) {
+      wifiSelector.startScan();
+    }
+  }
+  
+  if (radio == RADIO_FAST_RECONNECT) {
+    if (wifiSelector.finishFastConnect()) {
+      Serial.println("Connected using cached access point");
+      return true;
+    }
+    radio = RADIO_SCAN;
+    wifiSelector.startScan();
+  }
+  return connectWithScan();
+}
+
+// Scan path: saved network from the scan results, else let the user pick
+// (cold boot only; a timer wake goes back to sleep)
+bool connectWithScan() {
+  // The scan is already running channel by channel. Saved credentials need
+  // the full list; otherwise the user can start picking after the first results.
+  bool have_saved = wifiSelector.hasSavedCredentials();
+  auto networks = wifiSelector.waitForScan(!have_saved);
+  sleepCycle.recordScan(networks);
+  
+  if (networks.empty()) {
+    Serial.println("No networks found, cannot proceed");
+    return false;
+  }
+  
+  // 2. Try to connect with previously saved credentials
+  if (!wifiSelector.connectWithSavedCredentials(networks)) {
+    // Nobody is at the controls on a timer wake: sleep and try again next
+    // cycle instead of waiting in the picker with the radio on
+    if (sleepCycle.isWake()) {
+      Serial.println("No saved network in range, back to sleep");
+      return true;
+    }
+    // 3. If that fails, prompt user to select and connect to a network
+    if (wifiSelector.selectAndConnectNetwork(networks)) {
+      Serial.println("Successfully connected to selected network");
+    } else {
+      Serial.println("Failed to connect to any network");
+    }
+  } else {
+    Serial.println("Connected using saved credentials");
+  }
+  return true;
+}
+
+// Display, splash and RTC; runs while the radio is busy
+void entrypoint(){
   // Initialize I2C with custom pins
   Wire.begin(OLED_SDA_PIN, OLED_SCL_PIN);
   
@@ -86,6 +256,13 @@ void entrypoint(){
     for(;;); // Don't proceed, loop forever
   }
   
+  // Frames go out from a background task while the next one is drawn
+  display.setBusClock(OLED_I2C_CLOCK_HZ);
+  if (!display.beginAsync()) {
+    Serial.println("Display double buffering unavailable, sending inline");
+  }
+  bootTimeline.mark(BOOT_DISPLAY);
+  
   display.clearDisplay();
   display.setTextSize(1);
   display.setTextColor(SSD1306_WHITE);
@@ -93,4 +270,10 @@ void entrypoint(){
   display.println("WiFi Display Module");
   display.println("Initializing...");
   display.display();
+  bootTimeline.mark(BOOT_SPLASH);
+  
+  // Wall-clock time from the RTC on the same bus, before any network
+  display.waitTransfer();
+  timeService.begin();
+  bootTimeline.mark(BOOT_TIME);
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+#ifndef ADAFRUIT_GFX_H_HOST
+#define ADAFRUIT_GFX_H_HOST
+
+// ========================================
+// Adafruit GFX stand-in for the native build
+// ========================================
+// Mirrors the classic-font text path of Adafruit_GFX: every glyph goes
+// through drawChar() and one drawPixel() per set pixel, so host timings keep
+// the same shape as on the device. Only printable ASCII has glyphs.
+
+#include <Arduino.h>
+
+namespace host {
+
+// Classic 5x7 glcdfont, printable ASCII (0x20-0x7E), one byte per column
+inline const uint8_t gfx_font[95][5] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+  {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+  {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x08, 0x07, 0x03, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+  {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+  {0x00, 0x80, 0x70, 0x30, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x00, 0x60, 0x60, 0x00},
+  {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+  {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+  {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07},
+  {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x00, 0x14, 0x00, 0x00},
+  {0x00, 0x40, 0x34, 0x00, 0x00}, {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14},
+  {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x59, 0x09, 0x06}, {0x3E, 0x41, 0x5D, 0x59, 0x4E},
+  {0x7C, 0x12, 0x11, 0x12, 0x7C}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+  {0x7F, 0x41, 0x41, 0x41, 0x3E}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+  {0x3E, 0x41, 0x41, 0x51, 0x73}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+  {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+  {0x7F, 0x02, 0x1C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+  {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+  {0x26, 0x49, 0x49, 0x49, 0x32}, {0x03, 0x01, 0x7F, 0x01, 0x03}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+  {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+  {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x59, 0x49, 0x4D, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x41},
+  {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x41, 0x7F}, {0x04, 0x02, 0x01, 0x02, 0x04},
+  {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x03, 0x07, 0x08, 0x00}, {0x20, 0x54, 0x54, 0x78, 0x40},
+  {0x7F, 0x28, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x28}, {0x38, 0x44, 0x44, 0x28, 0x7F},
+  {0x38, 0x54, 0x54, 0x54, 0x18}, {0x00, 0x08, 0x7E, 0x09, 0x02}, {0x18, 0xA4, 0xA4, 0x9C, 0x78},
+  {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x40, 0x3D, 0x00},
+  {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x78, 0x04, 0x78},
+  {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0xFC, 0x18, 0x24, 0x24, 0x18},
+  {0x18, 0x24, 0x24, 0x18, 0xFC}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x24},
+  {0x04, 0x04, 0x3F, 0x44, 0x24}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+  {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x4C, 0x90, 0x90, 0x90, 0x7C},
+  {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x77, 0x00, 0x00},
+  {0x00, 0x41, 0x36, 0x08, 0x00}, {0x02, 0x01, 0x02, 0x04, 0x02}
+};
+
+} // namespace host
+
+struct GFXfont;
+
+class Adafruit_GFX : public Print {
+protected:
+  int16_t WIDTH;
+  int16_t HEIGHT;
+  int16_t _width;
+  int16_t _height;
+  int16_t cursor_x;
+  int16_t cursor_y;
+  uint16_t textcolor;
+  uint16_t textbgcolor;
+  uint8_t textsize_x;
+  uint8_t textsize_y;
+  uint8_t rotation;
+  bool wrap;
+  GFXfont* gfxFont;
+
+public:
+  Adafruit_GFX(int16_t w, int16_t h)
+    : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+      textcolor(0xFFFF), textbgcolor(0xFFFF), textsize_x(1), textsize_y(1),
+      rotation(0), wrap(true), gfxFont(nullptr) {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t j = 0; j < h; j++) drawPixel(x, y + j, color);
+  }
+
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+  }
+
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+  }
+
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                uint8_t size_x, uint8_t size_y) {
+    if ((x >= _width) || (y >= _height) || ((x + 6 * size_x - 1) < 0) ||
+        ((y + 8 * size_y - 1) < 0)) {
+      return;
+    }
+
+    const uint8_t* glyph = (c >= 0x20 && c <= 0x7E) ? host::gfx_font[c - 0x20] : host::gfx_font[0];
+
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = glyph[i];
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        if (line & 1) {
+          if (size_x == 1 && size_y == 1) {
+            drawPixel(x + i, y + j, color);
+          } else {
+            fillRect(x + i * size_x, y + j * size_y, size_x, size_y, color);
+          }
+        } else if (bg != color) {
+          if (size_x == 1 && size_y == 1) {
+            drawPixel(x + i, y + j, bg);
+          } else {
+            fillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);
+          }
+        }
+      }
+    }
+    if (bg != color) {
+      if (size_x == 1 && size_y == 1) {
+        drawFastVLine(x + 5, y, 8, bg);
+      } else {
+        fillRect(x + 5 * size_x, y, size_x, 8 * size_y, bg);
+      }
+    }
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+      if (wrap && ((cursor_x + textsize_x * 6) > _width)) {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+      cursor_x += textsize_x * 6;
+    }
+    return 1;
+  }
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = (s > 0) ? s : 1; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+  void cp437(bool = true) {}
+  void setFont(const GFXfont* f = nullptr) { gfxFont = (GFXfont*)f; }
+
+  void setRotation(uint8_t r) {
+    rotation = r & 3;
+    _width = (rotation & 1) ? HEIGHT : WIDTH;
+    _height = (rotation & 1) ? WIDTH : HEIGHT;
+  }
+  uint8_t getRotation() const { return rotation; }
+
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+};
+
+#endif // ADAFRUIT_GFX_H_HOST
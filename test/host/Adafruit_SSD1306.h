@@ -0,0 +1,293 @@
+#ifndef ADAFRUIT_SSD1306_H_HOST
+#define ADAFRUIT_SSD1306_H_HOST
+
+// ========================================
+// Adafruit SSD1306 stand-in for the native build
+// ========================================
+// In-memory framebuffer with the same protected members and the same
+// display() transfer as Adafruit_SSD1306 2.5.x. Attach a host::SSD1306Panel
+// to Wire to see what actually reaches the controller's GDDRAM.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_SETCONTRAST 0x81
+#define SSD1306_DISPLAYALLON_RESUME 0xA4
+#define SSD1306_NORMALDISPLAY 0xA6
+#define SSD1306_INVERTDISPLAY 0xA7
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_EXTERNALVCC 0x01
+#define SSD1306_SWITCHCAPVCC 0x02
+
+namespace host {
+
+// SSD1306 controller model: parses the command/data stream and keeps GDDRAM
+class SSD1306Panel : public I2CDevice {
+private:
+  uint8_t pending_cmd;
+  uint8_t pending_args;
+  uint8_t args[6];
+  uint8_t arg_count;
+
+  static uint8_t argsFor(uint8_t cmd) {
+    switch (cmd) {
+      case SSD1306_COLUMNADDR:
+      case SSD1306_PAGEADDR:
+      case 0xA3:
+        return 2;
+      case SSD1306_MEMORYMODE:
+      case SSD1306_SETCONTRAST:
+      case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+      case 0x26: case 0x27:
+        return 6;
+      case 0x29: case 0x2A:
+        return 5;
+      default:
+        return 0;
+    }
+  }
+
+  void command(uint8_t c) {
+    if (pending_args) {
+      args[arg_count++] = c;
+      if (--pending_args == 0) apply();
+      return;
+    }
+    pending_cmd = c;
+    arg_count = 0;
+    pending_args = argsFor(c);
+    if (!pending_args) apply();
+  }
+
+  void apply() {
+    if (pending_cmd == SSD1306_COLUMNADDR) {
+      col_start = args[0] & 0x7F;
+      col_end = args[1] & 0x7F;
+      col = col_start;
+    } else if (pending_cmd == SSD1306_PAGEADDR) {
+      page_start = args[0] & 7;
+      page_end = args[1] & 7;
+      page = page_start;
+    }
+  }
+
+  void data(uint8_t d) {
+    ram[page][col] = d;
+    data_bytes++;
+    if (col == col_end) {
+      col = col_start;
+      page = (page == page_end) ? page_start : page + 1;
+    } else {
+      col = (col + 1) & 0x7F;
+    }
+  }
+
+public:
+  uint8_t ram[8][128];
+  uint8_t col_start, col_end, col;
+  uint8_t page_start, page_end, page;
+  uint32_t data_bytes;  // GDDRAM bytes written
+
+  SSD1306Panel() { reset(); }
+
+  void reset() {
+    memset(ram, 0, sizeof(ram));
+    pending_cmd = 0;
+    pending_args = 0;
+    arg_count = 0;
+    col_start = 0; col_end = 127; col = 0;
+    page_start = 0; page_end = 7; page = 0;
+    data_bytes = 0;
+  }
+
+  void onWrite(const uint8_t* bytes, size_t n) override {
+    if (n == 0) return;
+    bool is_data = bytes[0] & 0x40;
+    for (size_t i = 1; i < n; i++) {
+      if (is_data) data(bytes[i]);
+      else command(bytes[i]);
+    }
+  }
+
+  // True when GDDRAM matches a page-organized framebuffer
+  bool matches(const uint8_t* framebuffer, int width = 128, int pages = 8) const {
+    for (int p = 0; p < pages; p++) {
+      if (memcmp(ram[p], framebuffer + p * width, width) != 0) return false;
+    }
+    return true;
+  }
+};
+
+} // namespace host
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+protected:
+  TwoWire* wire;
+  uint8_t* buffer;
+  int8_t i2caddr;
+  int8_t vccstate;
+  int8_t rstPin;
+  uint32_t wireClk;
+  uint32_t restoreClk;
+  uint8_t contrast;
+
+  static const uint16_t WIRE_MAX = I2C_BUFFER_LENGTH < 256 ? I2C_BUFFER_LENGTH : 256;
+
+  void ssd1306_command1(uint8_t c) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00);
+    wire->write(c);
+    wire->endTransmission();
+  }
+
+  void ssd1306_commandList(const uint8_t* c, uint8_t n) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00);
+    uint16_t bytes_out = 1;
+    while (n--) {
+      if (bytes_out >= WIRE_MAX) {
+        wire->endTransmission();
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x00);
+        bytes_out = 1;
+      }
+      wire->write(pgm_read_byte(c++));
+      bytes_out++;
+    }
+    wire->endTransmission();
+  }
+
+  void drawFastVLineInternal(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    if (x < 0 || x >= WIDTH) return;
+    if (y < 0) { h += y; y = 0; }
+    if (y + h > HEIGHT) h = HEIGHT - y;
+    for (int16_t j = y; j < y + h; j++) {
+      uint8_t* p = &buffer[x + (j / 8) * WIDTH];
+      uint8_t bit = 1 << (j & 7);
+      switch (color) {
+        case SSD1306_WHITE: *p |= bit; break;
+        case SSD1306_BLACK: *p &= ~bit; break;
+        case SSD1306_INVERSE: *p ^= bit; break;
+      }
+    }
+  }
+
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL)
+    : Adafruit_GFX(w, h), wire(twi ? twi : &Wire), buffer(nullptr), i2caddr(0),
+      vccstate(0), rstPin(rst_pin), wireClk(clkDuring), restoreClk(clkAfter), contrast(0) {}
+
+  ~Adafruit_SSD1306() {
+    if (buffer) {
+      free(buffer);
+      buffer = nullptr;
+    }
+  }
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0,
+             bool reset = true, bool periphBegin = true) {
+    (void)reset;
+    if (!buffer && !(buffer = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8)))) {
+      return false;
+    }
+    clearDisplay();
+    vccstate = switchvcc;
+    this->i2caddr = i2caddr ? i2caddr : ((HEIGHT == 32) ? 0x3C : 0x3D);
+    if (periphBegin) wire->begin();
+
+    // Reset pulse and init sequence as sent by the library (128x64, charge pump)
+    if (reset && rstPin >= 0) {
+      delay(1);
+      delay(10);
+    }
+    static const uint8_t init[] = {
+      SSD1306_DISPLAYOFF, 0xD5, 0x80, 0xA8, (uint8_t)(HEIGHT - 1), 0xD3, 0x00, 0x40,
+      0x8D, 0x14, SSD1306_MEMORYMODE, 0x00, 0xA1, 0xC8, 0xDA, 0x12, SSD1306_SETCONTRAST, 0xCF,
+      0xD9, 0xF1, 0xDB, 0x40, 0xA4, 0xA6, 0x2E, SSD1306_DISPLAYON
+    };
+    wire->setClock(wireClk);
+    ssd1306_commandList(init, sizeof(init));
+    wire->setClock(restoreClk);
+    return true;
+  }
+
+  void display() {
+    wire->setClock(wireClk);
+    static const uint8_t dlist1[] = {SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0};
+    ssd1306_commandList(dlist1, sizeof(dlist1));
+    ssd1306_command1(WIDTH - 1);
+
+    uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+    uint8_t* ptr = buffer;
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x40);
+    uint16_t bytes_out = 1;
+    while (count--) {
+      if (bytes_out >= WIRE_MAX) {
+        wire->endTransmission();
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x40);
+        bytes_out = 1;
+      }
+      wire->write(*ptr++);
+      bytes_out++;
+    }
+    wire->endTransmission();
+    wire->setClock(restoreClk);
+  }
+
+  void clearDisplay() {
+    memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if ((x < 0) || (y < 0) || (x >= width()) || (y >= height())) return;
+    switch (getRotation()) {
+      case 1: std::swap(x, y); x = WIDTH - x - 1; break;
+      case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+      case 3: std::swap(x, y); y = HEIGHT - y - 1; break;
+    }
+    switch (color) {
+      case SSD1306_WHITE: buffer[x + (y / 8) * WIDTH] |= (1 << (y & 7)); break;
+      case SSD1306_BLACK: buffer[x + (y / 8) * WIDTH] &= ~(1 << (y & 7)); break;
+      case SSD1306_INVERSE: buffer[x + (y / 8) * WIDTH] ^= (1 << (y & 7)); break;
+    }
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    if (getRotation() != 0) {
+      Adafruit_GFX::drawFastVLine(x, y, h, color);
+      return;
+    }
+    drawFastVLineInternal(x, y, h, color);
+  }
+
+  bool getPixel(int16_t x, int16_t y) {
+    if ((x < 0) || (y < 0) || (x >= WIDTH) || (y >= HEIGHT)) return false;
+    return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+  }
+
+  uint8_t* getBuffer() { return buffer; }
+
+  void ssd1306_command(uint8_t c) {
+    wire->setClock(wireClk);
+    ssd1306_command1(c);
+    wire->setClock(restoreClk);
+  }
+
+  void invertDisplay(bool i) { ssd1306_command(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY); }
+  void dim(bool) {}
+};
+
+#endif // ADAFRUIT_SSD1306_H_HOST
@@ -0,0 +1,311 @@
+#ifndef ARDUINO_H_HOST
+#define ARDUINO_H_HOST
+
+// ========================================
+// Arduino core stand-in for the native build
+// ========================================
+// Just enough of the ESP32 Arduino API for the code in lib/ to compile and
+// run on the host. Time and pins are driven by HostSim.h.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <algorithm>
+#include <ctime>
+#include "HostSim.h"
+
+#define ARDUINO 10819
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define PROGMEM
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define F(string_literal) (string_literal)
+#define pgm_read_byte(addr) (*(const unsigned char*)(addr))
+#define pgm_read_word(addr) (*(const unsigned short*)(addr))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef enum {
+  ADC_0db,
+  ADC_2_5db,
+  ADC_6db,
+  ADC_11db
+} adc_attenuation_t;
+
+// ----------------------------------------
+// Timing
+// ----------------------------------------
+
+inline unsigned long millis() {
+  return (unsigned long)(host::clock_us / 1000);
+}
+
+inline unsigned long micros() {
+  return (unsigned long)host::clock_us;
+}
+
+inline void delay(uint32_t ms) {
+  host::advance(ms);
+}
+
+inline void delayMicroseconds(uint32_t us) {
+  host::advance_us(us);
+}
+
+inline void yield() {}
+
+// CPU cycle counter, running at 240 MHz of simulated time
+class EspClass {
+public:
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getCycleCount() { return (uint32_t)(host::clock_us * 240); }
+};
+
+inline EspClass ESP;
+
+// ----------------------------------------
+// Network time (esp32-hal-time)
+// ----------------------------------------
+
+namespace host {
+
+// UTC at simulated time zero on the time servers; 0 = unreachable
+inline uint32_t ntp_epoch = 0;
+inline uint32_t ntp_sync_ms = 120;   // SNTP round trips until the first fix
+inline uint32_t ntp_syncs = 0;       // Fixes handed out
+inline bool sntp_running = false;
+inline uint64_t sntp_started_us = 0;
+
+} // namespace host
+
+inline void configTime(long, int, const char*, const char* = nullptr, const char* = nullptr) {
+  host::sntp_running = true;
+  host::sntp_started_us = host::clock_us;
+}
+
+// Waits for SNTP like the real one; UTC fields when configTime(0, 0, ...)
+inline bool getLocalTime(struct tm* info, uint32_t ms = 5000) {
+  if (!host::sntp_running || !host::ntp_epoch) {
+    host::advance(ms);
+    return false;
+  }
+  uint64_t fix_us = host::sntp_started_us + (uint64_t)host::ntp_sync_ms * 1000;
+  if (host::clock_us < fix_us) {
+    if (fix_us - host::clock_us > (uint64_t)ms * 1000) {
+      host::advance(ms);
+      return false;
+    }
+    host::advance_us(fix_us - host::clock_us);
+  }
+  host::ntp_syncs++;
+  time_t now = host::ntp_epoch + host::clock_us / 1000000;
+  gmtime_r(&now, info);
+  return true;
+}
+
+// ----------------------------------------
+// GPIO and ADC
+// ----------------------------------------
+
+inline void pinMode(uint8_t, uint8_t) {}
+
+inline int digitalRead(uint8_t pin) {
+  return host::digital_levels[pin & 63];
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level) {
+  host::digital_levels[pin & 63] = level;
+}
+
+inline uint16_t analogRead(uint8_t pin) {
+  return host::analog_values[pin & 63];
+}
+
+inline int digitalPinToInterrupt(uint8_t pin) {
+  return pin;
+}
+
+// Edges only reach handlers through host::set_pin()
+inline void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+  host::pin_interrupts[pin & 63] = {handler, arg, mode};
+}
+
+inline void detachInterrupt(uint8_t pin) {
+  host::pin_interrupts[pin & 63] = {nullptr, nullptr, 0};
+}
+
+inline void analogReadResolution(uint8_t) {}
+inline void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+
+// ----------------------------------------
+// String
+// ----------------------------------------
+
+// Heap-backed like the Arduino String, so the harness allocation counter
+// sees the same churn the device does.
+class String {
+private:
+  char* buf;
+  unsigned int len;
+
+  void assign(const char* s, unsigned int n) {
+    char* next = new char[n + 1];
+    if (n) memcpy(next, s, n);
+    next[n] = '\0';
+    delete[] buf;
+    buf = next;
+    len = n;
+  }
+
+public:
+  String(const char* s = "") : buf(nullptr), len(0) { assign(s ? s : "", s ? strlen(s) : 0); }
+  String(const String& other) : buf(nullptr), len(0) { assign(other.buf, other.len); }
+  String(String&& other) noexcept : buf(other.buf), len(other.len) { other.buf = nullptr; other.len = 0; }
+  explicit String(char c) : buf(nullptr), len(0) { assign(&c, 1); }
+  explicit String(int value) : buf(nullptr), len(0) { char t[16]; assign(t, snprintf(t, sizeof(t), "%d", value)); }
+  explicit String(unsigned int value) : buf(nullptr), len(0) { char t[16]; assign(t, snprintf(t, sizeof(t), "%u", value)); }
+  explicit String(long value) : buf(nullptr), len(0) { char t[24]; assign(t, snprintf(t, sizeof(t), "%ld", value)); }
+  explicit String(unsigned long value) : buf(nullptr), len(0) { char t[24]; assign(t, snprintf(t, sizeof(t), "%lu", value)); }
+  ~String() { delete[] buf; }
+
+  String& operator=(const String& other) { if (this != &other) assign(other.buf, other.len); return *this; }
+  String& operator=(String&& other) noexcept {
+    if (this != &other) { delete[] buf; buf = other.buf; len = other.len; other.buf = nullptr; other.len = 0; }
+    return *this;
+  }
+  String& operator=(const char* s) { assign(s ? s : "", s ? strlen(s) : 0); return *this; }
+
+  String& concat(const char* s, unsigned int n) {
+    char* next = new char[len + n + 1];
+    if (len) memcpy(next, buf, len);
+    if (n) memcpy(next + len, s, n);
+    next[len + n] = '\0';
+    delete[] buf;
+    buf = next;
+    len += n;
+    return *this;
+  }
+  String& operator+=(const String& other) { return concat(other.c_str(), other.len); }
+  String& operator+=(const char* s) { return concat(s, strlen(s)); }
+  String& operator+=(char c) { return concat(&c, 1); }
+
+  friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+  friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+
+  unsigned int length() const { return len; }
+  bool isEmpty() const { return len == 0; }
+  const char* c_str() const { return buf ? buf : ""; }
+  char operator[](unsigned int i) const { return i < len ? buf[i] : 0; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  bool equals(const String& other) const { return len == other.len && memcmp(c_str(), other.c_str(), len) == 0; }
+  bool equals(const char* s) const { return strcmp(c_str(), s) == 0; }
+  bool operator==(const String& other) const { return equals(other); }
+  bool operator==(const char* s) const { return equals(s); }
+  bool operator!=(const String& other) const { return !equals(other); }
+  bool operator!=(const char* s) const { return !equals(s); }
+
+  String substring(unsigned int from) const { return substring(from, len); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from > len) from = len;
+    if (to > len) to = len;
+    String r;
+    r.assign(c_str() + from, to - from);
+    return r;
+  }
+};
+
+// ----------------------------------------
+// Print
+// ----------------------------------------
+
+class Print;
+
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* data, size_t n) {
+    size_t count = 0;
+    while (n--) count += write(*data++);
+    return count;
+  }
+  size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n) { return printf("%d", n); }
+  size_t print(unsigned int n) { return printf("%u", n); }
+  size_t print(long n) { return printf("%ld", n); }
+  size_t print(unsigned long n) { return printf("%lu", n); }
+  size_t print(double n, int digits = 2) { return printf("%.*f", digits, n); }
+  size_t print(const Printable& p) { return p.printTo(*this); }
+
+  size_t println() { return write((const uint8_t*)"\r\n", 2); }
+  template <typename T>
+  size_t println(const T& value) { size_t n = print(value); return n + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t*)line, std::min((size_t)n, sizeof(line) - 1));
+  }
+};
+
+// ----------------------------------------
+// Serial
+// ----------------------------------------
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  void flush() {}
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (host::serial_echo) fputc(c, stdout);
+    return 1;
+  }
+  size_t write(const uint8_t* data, size_t n) override {
+    if (host::serial_echo) fwrite(data, 1, n, stdout);
+    return n;
+  }
+  operator bool() const { return true; }
+};
+
+inline HardwareSerial Serial;
+
+#endif // ARDUINO_H_HOST
@@ -0,0 +1,113 @@
+#ifndef FAKERTC_H_HOST
+#define FAKERTC_H_HOST
+
+// ========================================
+// DS3231 / DS1307 stand-in for the native build
+// ========================================
+// Attach to the simulated bus at 0x68. Time runs from the simulated clock,
+// off by drift_ppm like a real crystal, and is read and set through the
+// BCD time registers exactly as on the chips.
+
+#include <Wire.h>
+#include <ctime>
+
+namespace host {
+
+class FakeRtc : public I2CDevice {
+private:
+  uint8_t regs[64];
+  uint8_t pointer = 0;
+  bool ds1307;
+  int64_t base_epoch = 0;
+  uint64_t base_us = 0;
+  double drift_ppm = 0;
+
+  static uint8_t toBcd(int value) { return ((value / 10) << 4) | (value % 10); }
+  static int fromBcd(uint8_t value) { return (value >> 4) * 10 + (value & 0x0F); }
+
+  void refreshTime() {
+    time_t t = (time_t)now();
+    struct tm fields;
+    gmtime_r(&t, &fields);
+    regs[0] = toBcd(fields.tm_sec) | (regs[0] & 0x80);  // Keep the DS1307 halt bit
+    regs[1] = toBcd(fields.tm_min);
+    regs[2] = toBcd(fields.tm_hour);
+    regs[3] = fields.tm_wday + 1;
+    regs[4] = toBcd(fields.tm_mday);
+    regs[5] = toBcd(fields.tm_mon + 1);
+    regs[6] = toBcd(fields.tm_year - 100);
+  }
+
+  void applyTime() {
+    struct tm fields = {};
+    fields.tm_sec = fromBcd(regs[0] & 0x7F);
+    fields.tm_min = fromBcd(regs[1]);
+    fields.tm_hour = fromBcd(regs[2] & 0x3F);
+    fields.tm_mday = fromBcd(regs[4]);
+    fields.tm_mon = fromBcd(regs[5] & 0x1F) - 1;
+    fields.tm_year = fromBcd(regs[6]) + 100;
+    base_epoch = timegm(&fields);
+    base_us = clock_us;
+  }
+
+public:
+  uint32_t reads = 0;
+  uint32_t time_writes = 0;
+
+  explicit FakeRtc(bool is_ds1307 = false) : ds1307(is_ds1307) { memset(regs, 0, sizeof(regs)); }
+
+  // Set the time directly, as if it had been kept since
+  void set(uint32_t epoch) {
+    base_epoch = epoch;
+    base_us = clock_us;
+    if (ds1307) regs[0] &= 0x7F;
+    else regs[0x0F] &= 0x7F;
+  }
+
+  uint32_t now() const {
+    double elapsed = (double)(clock_us - base_us) / 1e6 * (1.0 + drift_ppm / 1e6);
+    return (uint32_t)(base_epoch + (int64_t)elapsed);
+  }
+
+  // Crystal error from here on
+  void setDrift(double ppm) {
+    set(now());
+    drift_ppm = ppm;
+  }
+
+  // Backup battery gone: oscillator-stop flag (DS3231) or clock halt (DS1307)
+  void losePower() {
+    set(0);
+    if (ds1307) regs[0] |= 0x80;
+    else regs[0x0F] |= 0x80;
+  }
+
+  void onWrite(const uint8_t* data, size_t n) override {
+    if (n == 0) return;
+    pointer = data[0] & 0x3F;
+    bool time_written = false;
+    for (size_t i = 1; i < n; i++) {
+      if (pointer <= 6) time_written = true;
+      regs[pointer] = data[i];
+      pointer = (pointer + 1) & 0x3F;
+    }
+    if (time_written) {
+      applyTime();
+      time_writes++;
+    }
+  }
+
+  size_t onRead(uint8_t* data, size_t n) override {
+    refreshTime();
+    for (size_t i = 0; i < n; i++) {
+      data[i] = regs[pointer];
+      pointer = (pointer + 1) & 0x3F;
+    }
+    reads++;
+    return n;
+  }
+};
+
+} // namespace host
+
+#endif // FAKERTC_H_HOST
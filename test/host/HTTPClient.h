@@ -0,0 +1,134 @@
+#ifndef HTTPCLIENT_H_HOST
+#define HTTPCLIENT_H_HOST
+
+// ========================================
+// HTTPClient stand-in for the native build
+// ========================================
+// Requests go to an in-process loopback server instead of a socket. The
+// client keeps its connection between requests to the same host when reuse
+// is on (the ESP32 default), like the real one. Connections, requests and
+// the bytes of each request are counted, and handshakes and round trips
+// advance the simulated clock.
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NO_CONTENT 204
+#define HTTP_CODE_SERVICE_UNAVAILABLE 503
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+
+namespace host {
+
+struct HttpRequest {
+  std::string method;
+  std::string host;
+  std::string path;
+  std::string headers;         // Request line and header block as sent
+  std::string body;
+};
+
+// Loopback server
+inline std::vector<HttpRequest> http_requests;
+inline std::function<int(const HttpRequest&)> http_handler;  // Status; unset = 200
+inline bool http_server_up = true;
+inline uint32_t http_connect_ms = 40;    // TCP handshake on the LAN
+inline uint32_t http_rtt_ms = 15;        // Request to response
+
+// Client side traffic
+inline uint32_t http_connections = 0;
+inline uint32_t http_bytes = 0;          // Request headers and bodies
+
+inline void http_reset() {
+  http_requests.clear();
+  http_handler = nullptr;
+  http_server_up = true;
+  http_connections = 0;
+  http_bytes = 0;
+}
+
+} // namespace host
+
+class WiFiClient {};
+
+class HTTPClient {
+private:
+  std::string host_name;
+  std::string path;
+  std::string extra_headers;
+  std::string response;
+  bool reuse = true;
+  bool connected = false;
+  std::string connected_host;
+
+  bool connect() {
+    if (!host::http_server_up) {
+      connected = false;  // Server gone: an open connection is reset too
+      return false;
+    }
+    if (connected && connected_host == host_name) return true;
+    host::advance(host::http_connect_ms);
+    host::http_connections++;
+    connected = true;
+    connected_host = host_name;
+    return true;
+  }
+
+public:
+  bool begin(const String& url) {
+    std::string text = url.c_str();
+    size_t scheme = text.find("://");
+    size_t start = scheme == std::string::npos ? 0 : scheme + 3;
+    size_t slash = text.find('/', start);
+    host_name = text.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+    path = slash == std::string::npos ? "/" : text.substr(slash);
+    extra_headers.clear();
+    return !host_name.empty();
+  }
+  bool begin(WiFiClient&, const String& url) { return begin(url); }
+
+  void setReuse(bool keep_alive) { reuse = keep_alive; }
+  void setTimeout(uint16_t) {}
+  void setConnectTimeout(int32_t) {}
+
+  void addHeader(const String& name, const String& value) {
+    extra_headers += std::string(name.c_str()) + ": " + value.c_str() + "\r\n";
+  }
+
+  int POST(const uint8_t* payload, size_t size) {
+    if (!connect()) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+    host::HttpRequest request;
+    request.method = "POST";
+    request.host = host_name;
+    request.path = path;
+    request.headers = "POST " + path + " HTTP/1.1\r\nHost: " + host_name +
+                      "\r\nUser-Agent: ESP32HTTPClient\r\nConnection: " +
+                      (reuse ? "keep-alive" : "close") + "\r\n" + extra_headers +
+                      "Content-Length: " + std::to_string(size) + "\r\n\r\n";
+    request.body.assign((const char*)payload, size);
+    host::http_bytes += request.headers.size() + size;
+    host::http_requests.push_back(request);
+
+    host::advance(host::http_rtt_ms);
+    int status = host::http_handler ? host::http_handler(request) : HTTP_CODE_OK;
+    response = status >= 200 && status < 300 ? "OK" : "Service Unavailable";
+    if (!reuse) connected = false;
+    return status;
+  }
+  int POST(const String& payload) { return POST((const uint8_t*)payload.c_str(), payload.length()); }
+
+  String getString() { return String(response.c_str()); }
+
+  // Keeps the connection open for the next request when reuse is on
+  void end() {
+    extra_headers.clear();
+    if (!reuse) connected = false;
+  }
+};
+
+#endif // HTTPCLIENT_H_HOST
@@ -0,0 +1,111 @@
+#ifndef HOSTSIM_H
+#define HOSTSIM_H
+
+// ========================================
+// Native host simulation controls
+// ========================================
+// Shared state behind the Arduino stand-ins in test/host. Time only moves
+// when code calls delay() (or the harness calls host::advance), so every
+// benchmark run is deterministic.
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace host {
+
+// Simulated clock in microseconds
+inline uint64_t clock_us = 0;
+
+// Pin state seen by analogRead()/digitalRead()
+inline int analog_values[64];
+inline int digital_levels[64];
+
+// GPIO interrupt handlers registered through attachInterruptArg()
+struct PinInterrupt {
+  void (*handler)(void*);
+  void* arg;
+  int mode;
+};
+
+inline PinInterrupt pin_interrupts[64];
+
+// Drive an input pin from outside, firing its interrupt like a real edge
+inline void set_pin(uint8_t pin, int level) {
+  pin &= 63;
+  int previous = digital_levels[pin];
+  digital_levels[pin] = level;
+
+  PinInterrupt& irq = pin_interrupts[pin];
+  if (!irq.handler || level == previous) return;
+  bool rising = level != 0;
+  if (irq.mode == 0x03 || (irq.mode == 0x01 && rising) || (irq.mode == 0x02 && !rising)) {
+    irq.handler(irq.arg);
+  }
+}
+
+// Heap allocations observed by the operator new replacement in the harness
+inline uint32_t alloc_count = 0;
+
+// Echo Serial output to stdout
+inline bool serial_echo = false;
+
+// Advance the clock by the time each I2C transaction takes on the wire
+inline bool model_bus_time = true;
+
+struct ScheduledEvent {
+  uint64_t at_us;
+  std::function<void()> action;
+};
+
+inline std::vector<ScheduledEvent> scheduled;
+
+// Run an action once the simulated clock reaches at_ms
+inline void at(uint32_t at_ms, std::function<void()> action) {
+  scheduled.push_back({(uint64_t)at_ms * 1000, action});
+}
+
+// Move the clock forward, firing scheduled actions in time order
+inline void advance_us(uint64_t us) {
+  uint64_t target = clock_us + us;
+
+  while (true) {
+    int next = -1;
+    for (size_t i = 0; i < scheduled.size(); i++) {
+      if (scheduled[i].at_us <= target &&
+          (next < 0 || scheduled[i].at_us < scheduled[next].at_us)) {
+        next = i;
+      }
+    }
+    if (next < 0) break;
+
+    ScheduledEvent event = scheduled[next];
+    scheduled.erase(scheduled.begin() + next);
+    if (event.at_us > clock_us) clock_us = event.at_us;
+    event.action();
+  }
+
+  if (target > clock_us) clock_us = target;
+}
+
+inline void advance(uint32_t ms) {
+  advance_us((uint64_t)ms * 1000);
+}
+
+inline uint32_t now_ms() {
+  return (uint32_t)(clock_us / 1000);
+}
+
+// Restore the clock, pins and schedule to power-on state
+inline void reset(int analog_rest = 2048) {
+  clock_us = 0;
+  scheduled.clear();
+  for (int i = 0; i < 64; i++) {
+    analog_values[i] = analog_rest;
+    digital_levels[i] = 1;  // Pulled up
+  }
+}
+
+} // namespace host
+
+#endif // HOSTSIM_H
@@ -0,0 +1,105 @@
+#ifndef PREFERENCES_H_HOST
+#define PREFERENCES_H_HOST
+
+// ========================================
+// NVS Preferences stand-in for the native build
+// ========================================
+// Namespaces live in memory for the lifetime of the process. Reads and writes
+// are counted so benchmarks can report NVS traffic.
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace host {
+
+typedef std::map<std::string, std::vector<uint8_t>> NvsNamespace;
+
+inline std::map<std::string, NvsNamespace> nvs;
+inline uint32_t nvs_reads = 0;
+inline uint32_t nvs_writes = 0;
+
+} // namespace host
+
+class Preferences {
+private:
+  host::NvsNamespace* ns = nullptr;
+  bool read_only = false;
+
+  const std::vector<uint8_t>* find(const char* key) {
+    host::nvs_reads++;
+    if (!ns) return nullptr;
+    auto it = ns->find(key);
+    return it == ns->end() ? nullptr : &it->second;
+  }
+
+  size_t store(const char* key, const void* value, size_t len) {
+    if (!ns || read_only) return 0;
+    host::nvs_writes++;
+    const uint8_t* bytes = (const uint8_t*)value;
+    (*ns)[key] = std::vector<uint8_t>(bytes, bytes + len);
+    return len;
+  }
+
+public:
+  bool begin(const char* name, bool readOnly = false) {
+    ns = &host::nvs[name];
+    read_only = readOnly;
+    return true;
+  }
+
+  void end() { ns = nullptr; }
+
+  bool clear() {
+    if (!ns || read_only) return false;
+    ns->clear();
+    return true;
+  }
+
+  bool remove(const char* key) {
+    if (!ns || read_only) return false;
+    return ns->erase(key) > 0;
+  }
+
+  bool isKey(const char* key) { return find(key) != nullptr; }
+
+  size_t putString(const char* key, const String& value) {
+    return store(key, value.c_str(), value.length() + 1);
+  }
+
+  String getString(const char* key, const String& defaultValue = String()) {
+    const std::vector<uint8_t>* v = find(key);
+    return v ? String((const char*)v->data()) : defaultValue;
+  }
+
+  size_t putBytes(const char* key, const void* value, size_t len) { return store(key, value, len); }
+
+  size_t getBytesLength(const char* key) {
+    const std::vector<uint8_t>* v = find(key);
+    return v ? v->size() : 0;
+  }
+
+  size_t getBytes(const char* key, void* buf, size_t maxLen) {
+    const std::vector<uint8_t>* v = find(key);
+    if (!v || v->size() > maxLen) return 0;
+    memcpy(buf, v->data(), v->size());
+    return v->size();
+  }
+
+  size_t putUChar(const char* key, uint8_t value) { return store(key, &value, 1); }
+  uint8_t getUChar(const char* key, uint8_t defaultValue = 0) {
+    const std::vector<uint8_t>* v = find(key);
+    return (v && v->size() == 1) ? (*v)[0] : defaultValue;
+  }
+
+  size_t putUInt(const char* key, uint32_t value) { return store(key, &value, 4); }
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0) {
+    const std::vector<uint8_t>* v = find(key);
+    uint32_t value = defaultValue;
+    if (v && v->size() == 4) memcpy(&value, v->data(), 4);
+    return value;
+  }
+};
+
+#endif // PREFERENCES_H_HOST
@@ -0,0 +1,383 @@
+#ifndef WIFI_H_HOST
+#define WIFI_H_HOST
+
+// ========================================
+// ESP32 WiFi stand-in for the native build
+// ========================================
+// Scans and connects against a scripted list of access points. Scan and
+// association times are charged to the simulated clock.
+
+#include <Arduino.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+typedef enum {
+  WIFI_AUTH_OPEN = 0,
+  WIFI_AUTH_WEP,
+  WIFI_AUTH_WPA_PSK,
+  WIFI_AUTH_WPA2_PSK,
+  WIFI_AUTH_WPA_WPA2_PSK,
+  WIFI_AUTH_WPA2_ENTERPRISE,
+  WIFI_AUTH_WPA3_PSK,
+  WIFI_AUTH_WPA2_WPA3_PSK,
+  WIFI_AUTH_WAPI_PSK,
+  WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+typedef enum {
+  WIFI_MODE_NULL = 0,
+  WIFI_MODE_STA,
+  WIFI_MODE_AP,
+  WIFI_MODE_APSTA
+} wifi_mode_t;
+
+#define WIFI_OFF   WIFI_MODE_NULL
+#define WIFI_STA   WIFI_MODE_STA
+#define WIFI_AP    WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum {
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+// Events and disconnect reasons (subset of arduino-esp32 2.x / ESP-IDF)
+typedef enum {
+  ARDUINO_EVENT_WIFI_READY = 0,
+  ARDUINO_EVENT_WIFI_SCAN_DONE,
+  ARDUINO_EVENT_WIFI_STA_START,
+  ARDUINO_EVENT_WIFI_STA_STOP,
+  ARDUINO_EVENT_WIFI_STA_CONNECTED,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_AUTHMODE_CHANGE,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP6,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP,
+  ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+typedef enum {
+  WIFI_REASON_UNSPECIFIED = 1,
+  WIFI_REASON_AUTH_EXPIRE = 2,
+  WIFI_REASON_ASSOC_LEAVE = 8,
+  WIFI_REASON_MIC_FAILURE = 14,
+  WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT = 15,
+  WIFI_REASON_802_1X_AUTH_FAILED = 23,
+  WIFI_REASON_BEACON_TIMEOUT = 200,
+  WIFI_REASON_NO_AP_FOUND = 201,
+  WIFI_REASON_AUTH_FAIL = 202,
+  WIFI_REASON_ASSOC_FAIL = 203,
+  WIFI_REASON_HANDSHAKE_TIMEOUT = 204,
+  WIFI_REASON_CONNECTION_FAIL = 205
+} wifi_err_reason_t;
+
+typedef struct {
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t bssid[6];
+  uint8_t reason;
+  int8_t rssi;
+} wifi_event_sta_disconnected_t;
+
+typedef struct {
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t bssid[6];
+  uint8_t channel;
+  wifi_auth_mode_t authmode;
+} wifi_event_sta_connected_t;
+
+typedef struct {
+  struct { struct { uint32_t addr; } ip, netmask, gw; } ip_info;
+  bool ip_changed;
+} ip_event_got_ip_t;
+
+// Driver scan record (leading fields of the ESP-IDF struct)
+typedef struct {
+  uint8_t bssid[6];
+  uint8_t ssid[33];
+  uint8_t primary;
+  int second;
+  int8_t rssi;
+  wifi_auth_mode_t authmode;
+} wifi_ap_record_t;
+
+typedef union {
+  wifi_event_sta_connected_t wifi_sta_connected;
+  wifi_event_sta_disconnected_t wifi_sta_disconnected;
+  ip_event_got_ip_t got_ip;
+} arduino_event_info_t;
+
+typedef arduino_event_id_t WiFiEvent_t;
+typedef arduino_event_info_t WiFiEventInfo_t;
+typedef std::function<void(arduino_event_id_t event, arduino_event_info_t info)> WiFiEventFuncCb;
+typedef size_t wifi_event_id_t;
+
+class IPAddress : public Printable {
+private:
+  uint8_t octets[4];
+
+public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+  IPAddress(uint32_t value) { memcpy(octets, &value, 4); }
+  operator uint32_t() const { uint32_t v; memcpy(&v, octets, 4); return v; }
+  uint8_t operator[](int i) const { return octets[i]; }
+
+  String toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+    return String(text);
+  }
+
+  size_t printTo(Print& p) const override {
+    return p.printf("%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+  }
+};
+
+namespace host {
+
+struct AccessPoint {
+  std::string ssid;
+  uint8_t bssid[6];
+  uint8_t channel;
+  int32_t rssi;
+  wifi_auth_mode_t auth;
+  std::string password;
+};
+
+// Scripted radio environment
+inline std::vector<AccessPoint> access_points;
+inline uint32_t wifi_connect_ms = 1500;       // Association + DHCP without a channel hint
+inline uint32_t wifi_fast_connect_ms = 400;   // With channel and BSSID given
+inline uint32_t wifi_dhcp_ms = 250;           // Part of either that a static IP skips
+inline uint32_t wifi_begin_count = 0;
+inline uint32_t wifi_scan_count = 0;
+
+inline AccessPoint make_ap(const char* ssid, uint8_t id, uint8_t channel, int32_t rssi,
+                           wifi_auth_mode_t auth = WIFI_AUTH_WPA2_PSK, const char* password = "password") {
+  AccessPoint ap;
+  ap.ssid = ssid;
+  uint8_t bssid[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, id};
+  memcpy(ap.bssid, bssid, 6);
+  ap.channel = channel;
+  ap.rssi = rssi;
+  ap.auth = auth;
+  ap.password = password;
+  return ap;
+}
+
+} // namespace host
+
+class WiFiClass {
+private:
+  wifi_mode_t current_mode = WIFI_MODE_NULL;
+  std::vector<const host::AccessPoint*> results;
+  std::vector<wifi_ap_record_t> records;
+  uint64_t scan_done_us = 0;
+  bool scan_running = false;
+
+  const host::AccessPoint* target = nullptr;
+  std::string target_password;
+  uint64_t connect_done_us = 0;
+  bool connecting = false;
+  uint32_t attempt = 0;        // Drops events of superseded attempts
+  IPAddress static_ip, static_gateway, static_subnet, static_dns;
+
+  struct EventHandler {
+    wifi_event_id_t id;
+    WiFiEventFuncCb callback;
+    arduino_event_id_t event;
+  };
+  std::vector<EventHandler> handlers;
+  wifi_event_id_t next_handler_id = 1;
+
+  void postEvent(arduino_event_id_t event, const arduino_event_info_t& info) {
+    std::vector<EventHandler> current = handlers;
+    for (const EventHandler& handler : current) {
+      if (handler.event == ARDUINO_EVENT_MAX || handler.event == event) {
+        handler.callback(event, info);
+      }
+    }
+  }
+
+  void postDisconnected(uint8_t reason) {
+    arduino_event_info_t info = {};
+    info.wifi_sta_disconnected.reason = reason;
+    postEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, info);
+  }
+
+  // Outcome of the current attempt once association and DHCP have had time
+  void finishAttempt() {
+    arduino_event_info_t info = {};
+    if (!target) {
+      postDisconnected(WIFI_REASON_NO_AP_FOUND);
+    } else if (!passwordAccepted()) {
+      postDisconnected(WIFI_REASON_AUTH_FAIL);
+    } else {
+      memcpy(info.wifi_sta_connected.bssid, target->bssid, 6);
+      info.wifi_sta_connected.channel = target->channel;
+      postEvent(ARDUINO_EVENT_WIFI_STA_CONNECTED, info);
+      info = {};
+      info.got_ip.ip_info.ip.addr = (uint32_t)localIP();
+      postEvent(ARDUINO_EVENT_WIFI_STA_GOT_IP, info);
+    }
+  }
+
+  bool passwordAccepted() const {
+    return target->auth == WIFI_AUTH_OPEN || target->password == target_password;
+  }
+
+  void runScan(bool show_hidden, uint32_t max_ms_per_chan, uint8_t channel) {
+    results.clear();
+    records.clear();
+    for (const host::AccessPoint& ap : host::access_points) {
+      if (channel && ap.channel != channel) continue;
+      if (!show_hidden && ap.ssid.empty()) continue;
+      results.push_back(&ap);
+      wifi_ap_record_t record = {};
+      memcpy(record.bssid, ap.bssid, 6);
+      strncpy((char*)record.ssid, ap.ssid.c_str(), 32);
+      record.primary = ap.channel;
+      record.rssi = (int8_t)ap.rssi;
+      record.authmode = ap.auth;
+      records.push_back(record);
+    }
+    uint32_t channels = channel ? 1 : 13;
+    scan_done_us = host::clock_us + (uint64_t)channels * max_ms_per_chan * 1000;
+    host::wifi_scan_count++;
+  }
+
+public:
+  bool mode(wifi_mode_t m) { current_mode = m; return true; }
+  wifi_mode_t getMode() const { return current_mode; }
+
+  // Scanning
+  int16_t scanNetworks(bool async = false, bool show_hidden = false, bool passive = false,
+                       uint32_t max_ms_per_chan = 300, uint8_t channel = 0,
+                       const char* ssid = nullptr, const uint8_t* bssid = nullptr) {
+    (void)passive; (void)ssid; (void)bssid;
+    if (scan_running) return WIFI_SCAN_RUNNING;
+    runScan(show_hidden, max_ms_per_chan, channel);
+    scan_running = true;
+    if (async) return WIFI_SCAN_RUNNING;
+    host::advance_us(scan_done_us - host::clock_us);
+    scan_running = false;
+    return results.size();
+  }
+
+  int16_t scanComplete() {
+    if (!scan_running) return results.empty() ? WIFI_SCAN_FAILED : (int16_t)results.size();
+    if (host::clock_us < scan_done_us) return WIFI_SCAN_RUNNING;
+    scan_running = false;
+    return results.size();
+  }
+
+  void scanDelete() { results.clear(); records.clear(); }
+  size_t getScanRecordCount() const { return records.size(); }  // Host only: driver memory held
+
+  void* getScanInfoByIndex(int i) { return i >= 0 && i < (int)records.size() ? &records[i] : nullptr; }
+
+  String SSID(uint8_t i) const { return i < results.size() ? String(results[i]->ssid.c_str()) : String(); }
+  int32_t RSSI(uint8_t i) const { return i < results.size() ? results[i]->rssi : 0; }
+  wifi_auth_mode_t encryptionType(uint8_t i) const { return i < results.size() ? results[i]->auth : WIFI_AUTH_OPEN; }
+  uint8_t* BSSID(uint8_t i) const { return i < results.size() ? (uint8_t*)results[i]->bssid : nullptr; }
+  int32_t channel(uint8_t i) const { return i < results.size() ? results[i]->channel : 0; }
+
+  // Station
+  wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0,
+                    const uint8_t* bssid = nullptr, bool connect = true) {
+    (void)connect;
+    host::wifi_begin_count++;
+    target = nullptr;
+    for (const host::AccessPoint& ap : host::access_points) {
+      if (ap.ssid != ssid) continue;
+      if (channel && ap.channel != channel) continue;
+      if (bssid && memcmp(ap.bssid, bssid, 6) != 0) continue;
+      if (!target || ap.rssi > target->rssi) target = &ap;
+    }
+    target_password = passphrase ? passphrase : "";
+    connecting = true;
+    uint32_t ms = (channel && bssid) ? host::wifi_fast_connect_ms : host::wifi_connect_ms;
+    if ((uint32_t)static_ip) ms -= std::min(ms, host::wifi_dhcp_ms);
+    connect_done_us = host::clock_us + (uint64_t)ms * 1000;
+
+    uint32_t this_attempt = ++attempt;
+    host::at((uint32_t)((connect_done_us + 999) / 1000), [this, this_attempt] {
+      if (attempt == this_attempt) finishAttempt();
+    });
+    return WL_DISCONNECTED;
+  }
+
+  wl_status_t begin(const String& ssid, const String& passphrase = String(), int32_t channel = 0,
+                    const uint8_t* bssid = nullptr, bool connect = true) {
+    return begin(ssid.c_str(), passphrase.c_str(), channel, bssid, connect);
+  }
+
+  // A rejected password leaves the station retrying, as on the real stack
+  wl_status_t status() const {
+    if (!connecting) return WL_DISCONNECTED;
+    if (host::clock_us < connect_done_us) return WL_DISCONNECTED;
+    if (!target) return WL_NO_SSID_AVAIL;
+    if (!passwordAccepted()) return WL_DISCONNECTED;
+    return WL_CONNECTED;
+  }
+
+  bool disconnect(bool = false, bool = false) {
+    bool was_active = connecting;
+    connecting = false;
+    target = nullptr;
+    attempt++;
+    if (was_active) postDisconnected(WIFI_REASON_ASSOC_LEAVE);
+    return true;
+  }
+
+  // Events are delivered synchronously at the simulated time they occur
+  wifi_event_id_t onEvent(WiFiEventFuncCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX) {
+    handlers.push_back({next_handler_id, callback, event});
+    return next_handler_id++;
+  }
+
+  void removeEvent(wifi_event_id_t id) {
+    for (size_t i = 0; i < handlers.size(); i++) {
+      if (handlers[i].id == id) {
+        handlers.erase(handlers.begin() + i);
+        return;
+      }
+    }
+  }
+
+  // A zero address goes back to DHCP
+  bool config(IPAddress local_ip, IPAddress gateway, IPAddress subnet, IPAddress dns1 = IPAddress()) {
+    static_ip = local_ip;
+    static_gateway = gateway;
+    static_subnet = subnet;
+    static_dns = dns1;
+    return true;
+  }
+
+  IPAddress localIP() const {
+    if (status() != WL_CONNECTED) return IPAddress();
+    return (uint32_t)static_ip ? static_ip : IPAddress(192, 168, 1, 42);
+  }
+  IPAddress gatewayIP() const { return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 1) : IPAddress(); }
+  IPAddress subnetMask() const { return status() == WL_CONNECTED ? IPAddress(255, 255, 255, 0) : IPAddress(); }
+  IPAddress dnsIP(uint8_t = 0) const { return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 1) : IPAddress(); }
+  String SSID() const { return status() == WL_CONNECTED ? String(target->ssid.c_str()) : String(); }
+  uint8_t* BSSID() const { return status() == WL_CONNECTED ? (uint8_t*)target->bssid : nullptr; }
+  int32_t channel() const { return status() == WL_CONNECTED ? target->channel : 0; }
+  int32_t RSSI() const { return status() == WL_CONNECTED ? target->rssi : 0; }
+};
+
+inline WiFiClass WiFi;
+
+#endif // WIFI_H_HOST
@@ -0,0 +1,116 @@
+#ifndef WIRE_H_HOST
+#define WIRE_H_HOST
+
+// ========================================
+// I2C bus stand-in for the native build
+// ========================================
+// Transactions are routed to simulated devices by address and counted, so
+// benchmarks can report what would actually go over the bus.
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+namespace host {
+
+// A device attached to the simulated bus
+class I2CDevice {
+public:
+  virtual ~I2CDevice() {}
+  virtual void onWrite(const uint8_t* data, size_t n) = 0;
+  virtual size_t onRead(uint8_t*, size_t) { return 0; }
+};
+
+} // namespace host
+
+class TwoWire {
+private:
+  host::I2CDevice* devices[128];
+  uint32_t clock_hz;
+  uint8_t tx_address;
+  uint8_t tx_buffer[I2C_BUFFER_LENGTH];
+  size_t tx_length;
+  uint8_t rx_buffer[I2C_BUFFER_LENGTH];
+  size_t rx_length;
+  size_t rx_index;
+
+  // Statistics
+  uint32_t transactions;
+  uint32_t bytes_on_bus;     // Address + payload bytes
+  uint64_t bus_time_us;
+
+  void accountTransfer(size_t payload) {
+    transactions++;
+    bytes_on_bus += payload + 1;
+    // 9 clocks per byte plus start/stop
+    uint64_t us = ((payload + 1) * 9 + 2) * 1000000ULL / clock_hz;
+    bus_time_us += us;
+    if (host::model_bus_time) host::advance_us(us);
+  }
+
+public:
+  TwoWire() : clock_hz(100000), tx_address(0), tx_length(0), rx_length(0), rx_index(0) {
+    memset(devices, 0, sizeof(devices));
+    resetStats();
+  }
+
+  bool begin(int = -1, int = -1, uint32_t frequency = 0) {
+    if (frequency) clock_hz = frequency;
+    return true;
+  }
+  bool setClock(uint32_t frequency) { clock_hz = frequency; return true; }
+  uint32_t getClock() const { return clock_hz; }
+
+  void beginTransmission(uint8_t address) {
+    tx_address = address & 0x7F;
+    tx_length = 0;
+  }
+
+  size_t write(uint8_t data) {
+    if (tx_length >= sizeof(tx_buffer)) return 0;
+    tx_buffer[tx_length++] = data;
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t n) {
+    size_t count = 0;
+    while (n-- && write(*data++)) count++;
+    return count;
+  }
+
+  uint8_t endTransmission(bool = true) {
+    accountTransfer(tx_length);
+    host::I2CDevice* device = devices[tx_address];
+    if (!device) return 2;  // NACK on address
+    device->onWrite(tx_buffer, tx_length);
+    return 0;
+  }
+
+  uint8_t requestFrom(uint8_t address, size_t n, bool = true) {
+    host::I2CDevice* device = devices[address & 0x7F];
+    if (n > sizeof(rx_buffer)) n = sizeof(rx_buffer);
+    rx_length = device ? device->onRead(rx_buffer, n) : 0;
+    rx_index = 0;
+    accountTransfer(n);
+    return rx_length;
+  }
+
+  int available() { return rx_length - rx_index; }
+  int read() { return rx_index < rx_length ? rx_buffer[rx_index++] : -1; }
+
+  // Simulation hooks
+  void attach(uint8_t address, host::I2CDevice* device) { devices[address & 0x7F] = device; }
+  void detach(uint8_t address) { devices[address & 0x7F] = nullptr; }
+  uint32_t getTransactions() const { return transactions; }
+  uint32_t getBytesOnBus() const { return bytes_on_bus; }
+  uint64_t getBusTimeUs() const { return bus_time_us; }
+  void resetStats() {
+    transactions = 0;
+    bytes_on_bus = 0;
+    bus_time_us = 0;
+  }
+};
+
+inline TwoWire Wire;
+
+#endif // WIRE_H_HOST
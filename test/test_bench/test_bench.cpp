@@ -0,0 +1,1850 @@
+// ========================================
+// Host benchmark suite
+// ========================================
+// Drives the UI code over simulated time against the stand-ins in
+// test/host and reports frames, I2C traffic and heap allocations.
+//
+//   pio test -e native -v
+
+#include <unity.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include <WiFi.h>
+#include <Preferences.h>
+#include <HTTPClient.h>
+#include <new>
+#include <chrono>
+#include <thread>
+#include "PartialDisplay.h"
+#include "ScrollingText.h"
+#include "KeyInput.h"
+#include "WiFiSelector.h"
+#include "NetworkListView.h"
+#include "CredentialStore.h"
+#include "ConnectionEngine.h"
+#include "SpscQueue.h"
+#include "TaskRuntime.h"
+#include "SleepCycle.h"
+#include "Uplink.h"
+#include "TimeService.h"
+#include "FakeRtc.h"
+#include "Trace.h"
+#include "BootTimeline.h"
+#include "configs.h"
+
+// Count every heap allocation made by the code under test
+void* operator new(size_t size) {
+  host::alloc_count++;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// Globals the libraries expect from main.cpp
+Preferences pref;
+PartialDisplay display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET_PIN);
+host::SSD1306Panel panel;
+
+struct BenchStart {
+  uint32_t bus_bytes;
+  uint32_t allocs;
+  uint32_t time_ms;
+};
+
+static BenchStart bench_begin() {
+  host::reset(POT_CENTER);
+  panel.reset();
+  Wire.attach(OLED_I2C_ADDRESS, &panel);
+  display.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS);
+  display.clearDisplay();
+  display.display();
+  display.resetStats();
+  return {Wire.getBytesOnBus(), host::alloc_count, host::now_ms()};
+}
+
+static void bench_report(const char* name, const BenchStart& start, uint32_t frames) {
+  uint32_t bytes = Wire.getBytesOnBus() - start.bus_bytes;
+  uint32_t allocs = host::alloc_count - start.allocs;
+  uint32_t div = frames ? frames : 1;
+  printf("[bench] %-18s frames=%-5u i2c_bytes/frame=%-8.1f allocs/frame=%-6.2f sim_ms=%u\n",
+         name, frames, (double)bytes / div, (double)allocs / div, host::now_ms() - start.time_ms);
+}
+
+// No scheduler on the host: waitFrame() samples the controls inline
+void setUp() {
+  runtime.setInputStep([](void*) { sample_controls(); });
+}
+void tearDown() {}
+
+// Scrolling SSID strip as drawn by the network selection screen
+void test_scrolling_text() {
+  ScrollingText scroller;
+  scroller.setDisplayWidth(18, 108);
+  scroller.enableSmoothScroll(true, 6);
+  scroller.setScrollStep(1);
+  scroller.setScrollDelay(50);
+  scroller.setPauseDelay(1500);
+  scroller.setText("Corporate-Guest-Network-5GHz-Floor3");
+
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+
+  // Reference: whole framebuffer pushed every frame
+  BenchStart start = bench_begin();
+  for (int frame = 0; frame < 500; frame++) {
+    scroller.update();
+    scroller.drawWithBackground(&display, 36, 16, 1, SSD1306_WHITE, SSD1306_BLACK);
+    display.Adafruit_SSD1306::display();
+    delay(20);
+  }
+  bench_report("scrolling_full", start, 500);
+
+  scroller.reset();
+  start = bench_begin();
+  for (int frame = 0; frame < 500; frame++) {
+    scroller.update();
+    scroller.drawWithBackground(&display, 36, 16, 1, SSD1306_WHITE, SSD1306_BLACK);
+    display.display();
+    delay(20);
+  }
+  bench_report("scrolling_text", start, display.getFlushCount() + display.getSkippedCount());
+
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+  // update() and draw() run entirely out of the inline buffer
+  TEST_ASSERT_EQUAL_UINT32(start.allocs, host::alloc_count);
+}
+
+// Strip blit against the Adafruit GFX glyph path it replaces
+void test_scrolling_render_cost() {
+  bench_begin();
+  ScrollingText label(20, 120);
+  label.setText("Guest WiFi");
+
+  // Same pixels as GFX print, on and off page boundaries
+  static uint8_t expected[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+  for (int y : {16, 13}) {
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    display.setCursor(4, y);
+    display.print("Guest WiFi");
+    memcpy(expected, display.getBuffer(), sizeof(expected));
+
+    display.clearDisplay();
+    label.draw(&display, 4, y);
+    TEST_ASSERT_EQUAL_MEMORY(expected, display.getBuffer(), sizeof(expected));
+  }
+
+  // Bytes outside printable ASCII are blank cells of the normal width
+  static const uint8_t blank[FONT5X7_WIDTH] = {0};
+  for (int c : {0x01, 0x1F, 0x7F, 0x80, 0xC3, 0xFF}) {
+    TEST_ASSERT_EQUAL_MEMORY(blank, font5x7_glyph((char)c), FONT5X7_WIDTH);
+  }
+  ScrollingText utf8(20, 120);
+  utf8.setText("Caf\xC3\xA9 5G");
+  display.clearDisplay();
+  display.setCursor(4, 16);
+  display.print("Caf   5G");
+  memcpy(expected, display.getBuffer(), sizeof(expected));
+  display.clearDisplay();
+  utf8.draw(&display, 4, 16);
+  TEST_ASSERT_EQUAL_MEMORY(expected, display.getBuffer(), sizeof(expected));
+
+  ScrollingText scroller(18, 108, 0, 0);
+  scroller.setText("Corporate-Guest-Network-5GHz-Floor3");
+  const int frames = 20000;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) {
+    display.fillRect(36, 16, 108, 8, SSD1306_BLACK);
+    display.setCursor(36, 16);
+    display.print("Corporate-Guest-Net");
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) {
+    scroller.drawWithBackground(&display, 36, 16);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double gfx_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / frames;
+  double blit_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / frames;
+  printf("[bench] %-18s gfx_ns/frame=%-8.0f blit_ns/frame=%-8.0f speedup=%.1fx\n",
+         "scroll_render", gfx_ns, blit_ns, gfx_ns / blit_ns);
+}
+
+// Cursor walk and typing on the on-screen keyboard
+struct KeyboardCost {
+  double move_bytes;
+  double key_bytes;
+  double move_ns;
+  bool panel_matches;
+};
+
+static KeyboardCost keyboard_session(bool retained) {
+  bench_begin();
+  invalidate_keyboard();
+  draw_keyboard(0, 0, "");
+
+  char text[24] = "";
+  uint32_t moves = 0;
+  uint32_t before = Wire.getBytesOnBus();
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint8_t row = 0; row < 6; row++) {
+    for (uint8_t col = 0; col < 18; col++) {
+      if (!retained) invalidate_keyboard();
+      draw_keyboard(col, row, text);
+      moves++;
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  uint32_t move_bytes = Wire.getBytesOnBus() - before;
+
+  // Type a 20-character key: one move and one keystroke per character
+  before = Wire.getBytesOnBus();
+  for (int i = 0; i < 20; i++) {
+    text[i] = 'a' + i;
+    text[i + 1] = '\0';
+    if (!retained) invalidate_keyboard();
+    draw_keyboard(i % 18, 2, text);
+  }
+  uint32_t key_bytes = Wire.getBytesOnBus() - before;
+
+  return {(double)move_bytes / moves, (double)key_bytes / 20,
+          std::chrono::duration<double, std::nano>(t1 - t0).count() / moves,
+          panel.matches(display.getBuffer())};
+}
+
+void test_draw_keyboard() {
+  set_keyboard_layout(CLASSIC_KEYS);
+  KeyboardCost full = keyboard_session(false);
+  KeyboardCost retained = keyboard_session(true);
+  TEST_ASSERT_TRUE(full.panel_matches && retained.panel_matches);
+
+  // What every keystroke cost when each redraw pushed a whole frame
+  uint32_t before = Wire.getBytesOnBus();
+  display.invalidate();
+  display.display();
+  uint32_t frame_bytes = Wire.getBytesOnBus() - before;
+
+  printf("[bench] %-18s full:     i2c_bytes/move=%-6.1f i2c_bytes/key=%-6.1f ns/move=%.0f\n",
+         "draw_keyboard", full.move_bytes, full.key_bytes, full.move_ns);
+  printf("[bench] %-18s retained: i2c_bytes/move=%-6.1f i2c_bytes/key=%-6.1f ns/move=%.0f\n",
+         "draw_keyboard", retained.move_bytes, retained.key_bytes, retained.move_ns);
+  printf("[bench] %-18s full-frame push: i2c_bytes/key=%u\n", "draw_keyboard", frame_bytes);
+  TEST_ASSERT_TRUE(retained.move_bytes <= full.move_bytes);
+  TEST_ASSERT_TRUE(retained.move_ns * 5 < full.move_ns);
+
+  // Redrawing an unchanged keyboard must not touch the bus
+  before = Wire.getBytesOnBus();
+  draw_keyboard(5, 2, "hunter2");
+  uint32_t after_first = Wire.getBytesOnBus();
+  draw_keyboard(5, 2, "hunter2");
+  TEST_ASSERT_TRUE(after_first > before);
+  TEST_ASSERT_EQUAL_UINT32(after_first, Wire.getBytesOnBus());
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+  set_keyboard_layout(FREQUENCY_KEYS);
+}
+
+// Cursor travel typing WiFi passphrases on each layout
+static const char* const PASSPHRASES[] = {
+  "sunshine2024", "Password123!", "MyHomeWiFi_5G", "correct horse battery",
+  "qwerty12345", "Tr0ub4dor&3", "CoffeeShop#42", "letmein!2023",
+  "8f3kx92mzq7w", "dragonfly99", "Guest@Office", "blue-river-77",
+  "k7Ds9pQ2xLm4Wz8rT1vB"  // 20-character WPA key
+};
+
+struct TravelCost {
+  uint32_t moves;
+  uint32_t presses;
+  uint32_t chars;
+};
+
+static bool find_on_page(const KeyGrid& keys, uint8_t page, uint8_t key, uint8_t& row, uint8_t& col) {
+  for (row = 0; row < keys.rows; row++) {
+    for (col = 0; col < keys.cols; col++) {
+      if (keys.key(page, row, col) == key) return true;
+    }
+  }
+  return false;
+}
+
+// Pot steps and button presses to type text and confirm it, page keys included
+static TravelCost type_cost(const KeyGrid& keys, const char* text) {
+  TravelCost cost = {0, 0, 0};
+  uint8_t page = 0, row = keys.home_row, col = keys.home_col;
+
+  for (const char* c = text; ; c++) {
+    uint8_t key = !*c ? LEFT_CHAR : *c == ' ' ? SPACE_CHAR : (uint8_t)*c;
+    uint8_t key_row = 0, key_col = 0;
+
+    for (uint8_t flips = 0; !find_on_page(keys, page, key, key_row, key_col); flips++) {
+      if (flips == keys.pages || !find_on_page(keys, page, PAGE_CHAR, key_row, key_col)) {
+        return {0, 0, 0};
+      }
+      cost.moves += keys.distance(row, col, key_row, key_col);
+      cost.presses++;
+      row = key_row;
+      col = key_col;
+      page = (page + 1) % keys.pages;
+    }
+
+    cost.moves += keys.distance(row, col, key_row, key_col);
+    cost.presses++;
+    row = key_row;
+    col = key_col;
+    if (!*c) break;
+    cost.chars++;
+  }
+  return cost;
+}
+
+void test_keyboard_layouts() {
+  const KeyGrid* layouts[] = {&CLASSIC_KEYS, &FREQUENCY_KEYS};
+  const char* names[] = {"classic", "frequency"};
+  double moves_per_char[2];
+
+  // Every printable character is reachable on both layouts
+  for (int l = 0; l < 2; l++) {
+    for (char c = '!'; c <= '~'; c++) {
+      uint8_t p, r, col;
+      TEST_ASSERT_TRUE(layouts[l]->find((uint8_t)c, p, r, col));
+    }
+  }
+
+  for (int l = 0; l < 2; l++) {
+    TravelCost total = {0, 0, 0};
+    for (const char* text : PASSPHRASES) {
+      TravelCost cost = type_cost(*layouts[l], text);
+      TEST_ASSERT_TRUE(cost.chars > 0);
+      total.moves += cost.moves;
+      total.presses += cost.presses;
+      total.chars += cost.chars;
+    }
+    TravelCost wpa = type_cost(*layouts[l], PASSPHRASES[12]);
+    moves_per_char[l] = (double)total.moves / total.chars;
+    printf("[bench] %-18s %-9s moves/char=%-5.2f presses/char=%-5.2f wpa20_moves=%u\n",
+           "keyboard_layouts", names[l], moves_per_char[l], (double)total.presses / total.chars, wpa.moves);
+  }
+  TEST_ASSERT_TRUE(moves_per_char[1] < moves_per_char[0]);
+}
+
+// Typing on the default layout: up to 'a', shift page, 'A', long press to finish
+void test_prompt_keyboard() {
+  bench_begin();
+  init_controls();
+  uint32_t t = host::now_ms() + 100;
+  host::at(t, [] { host::analog_values[POT_Y_PIN] = 0; });
+  host::at(t + 150, [] { host::analog_values[POT_Y_PIN] = POT_CENTER; });
+  host::at(t + 400, [] { host::set_pin(BTN_SELECT, LOW); });    // 'a'
+  host::at(t + 500, [] { host::set_pin(BTN_SELECT, HIGH); });
+  host::at(t + 800, [] { host::analog_values[POT_Y_PIN] = 4095; });
+  host::at(t + 950, [] { host::analog_values[POT_Y_PIN] = POT_CENTER; });
+  host::at(t + 1200, [] { host::set_pin(BTN_SELECT, LOW); });   // Page
+  host::at(t + 1300, [] { host::set_pin(BTN_SELECT, HIGH); });
+  host::at(t + 1600, [] { host::analog_values[POT_Y_PIN] = 0; });
+  host::at(t + 1750, [] { host::analog_values[POT_Y_PIN] = POT_CENTER; });
+  host::at(t + 2000, [] { host::set_pin(BTN_SELECT, LOW); });   // 'A'
+  host::at(t + 2100, [] { host::set_pin(BTN_SELECT, HIGH); });
+  host::at(t + 2400, [] { host::set_pin(BTN_SELECT, LOW); });   // Long press
+  host::at(t + 3400, [] { host::set_pin(BTN_SELECT, HIGH); });
+
+  TEST_ASSERT_EQUAL_STRING("aA", prompt_keyboard());
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+
+  // Let the release through so the next test starts with the button up
+  while (host::now_ms() < t + 3500) runtime.waitFrame();
+  flush_input();
+}
+
+// Polled keyboard: other work keeps running, a full WPA passphrase fits
+void test_keyinput_poll() {
+  bench_begin();
+  init_controls();
+  char text[KEYINPUT_MAX_LENGTH + 1];
+  KeyInput keyboard(text, sizeof(text));
+  TEST_ASSERT_EQUAL(63, (int)keyboard.getCapacity());
+
+  // Step off the page key, tap past the capacity, then long press to finish
+  uint32_t t = host::now_ms() + 100;
+  host::at(t, [] { host::analog_values[POT_Y_PIN] = 0; });
+  host::at(t + 150, [] { host::analog_values[POT_Y_PIN] = POT_CENTER; });
+  t += 400;
+  for (uint32_t i = 0; i < 70; i++) {
+    host::at(t + i * 200, [] { host::set_pin(BTN_SELECT, LOW); });
+    host::at(t + i * 200 + 80, [] { host::set_pin(BTN_SELECT, HIGH); });
+  }
+  t += 70 * 200;
+  host::at(t, [] { host::set_pin(BTN_SELECT, LOW); });
+  host::at(t + 1000, [] { host::set_pin(BTN_SELECT, HIGH); });
+
+  keyboard.begin();
+  TEST_ASSERT_TRUE(keyboard.isActive());
+  uint32_t frames = 0;
+  while (!keyboard.poll()) {
+    frames++;  // Stands in for scroll, scan and WiFi work between polls
+    runtime.waitFrame();
+  }
+  printf("[bench] %-18s frames_while_typing=%-5u length=%u\n", "keyinput_poll", frames,
+         (unsigned)keyboard.getLength());
+  TEST_ASSERT_FALSE(keyboard.isActive());
+  TEST_ASSERT_TRUE(frames > 70);
+  TEST_ASSERT_EQUAL(63, (int)keyboard.getLength());
+  TEST_ASSERT_EQUAL(63, (int)strlen(keyboard.result()));
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+
+  while (host::now_ms() < t + 1100) runtime.waitFrame();
+  flush_input();
+}
+
+// Holding a pot: time to cross a keyboard row and the office network list
+static uint32_t hold_until_steps(uint8_t pin, uint8_t type, int steps) {
+  host::analog_values[pin] = 4095;
+  uint32_t t0 = host::now_ms();
+  int seen = 0;
+  InputEvent event;
+  while (seen < steps && host::now_ms() - t0 < 10000) {
+    runtime.waitFrame();
+    while (next_input(event)) {
+      if (event.type == type) seen++;
+    }
+  }
+  uint32_t elapsed = host::now_ms() - t0;
+  host::analog_values[pin] = POT_CENTER;
+  for (int i = 0; i < 10; i++) runtime.waitFrame();
+  flush_input();
+  return elapsed;
+}
+
+void test_axis_repeat() {
+  bench_begin();
+  init_controls();
+  for (int i = 0; i < 10; i++) runtime.waitFrame();
+  flush_input();
+
+  // A single-sample spike is filtered out
+  uint32_t t = host::now_ms() + 20;
+  host::at(t, [] { host::analog_values[POT_X_PIN] = 4095; });
+  host::at(t + 4, [] { host::analog_values[POT_X_PIN] = POT_CENTER; });
+  for (int i = 0; i < 10; i++) runtime.waitFrame();
+  InputEvent event;
+  TEST_ASSERT_FALSE(next_input(event));
+
+  // One hold replaces a flick per column/network
+  uint32_t row_ms = hold_until_steps(POT_X_PIN, NAV_RIGHT, 17);
+  uint32_t list_ms = hold_until_steps(POT_Y_PIN, NAV_DOWN, 39);
+
+  // Old engine: one step per flick, at most one zone change per 150 ms
+  uint32_t flick_row_ms = 17 * 2 * MOVE_DELAY;
+  uint32_t flick_list_ms = 39 * 2 * MOVE_DELAY;
+  printf("[bench] %-18s row_17_ms=%-5u (flicks: 17, >=%u ms)  list_39_ms=%-5u (flicks: 39, >=%u ms)\n",
+         "axis_repeat", row_ms, flick_row_ms, list_ms, flick_list_ms);
+  TEST_ASSERT_TRUE(row_ms * 3 < flick_row_ms);
+  TEST_ASSERT_TRUE(list_ms * 4 < flick_list_ms);
+}
+
+// Select button edges from the ISR: taps, bounce, long and double presses
+static int run_button_frames(int frames, uint8_t* types, int max) {
+  int count = 0;
+  InputEvent event;
+  for (int i = 0; i < frames; i++) {
+    runtime.waitFrame();
+    while (next_input(event)) {
+      if (event.type >= NAV_SELECT && count < max) types[count++] = event.type;
+    }
+  }
+  return count;
+}
+
+void test_button_events() {
+  bench_begin();
+  init_controls();
+  runtime.waitFrame();
+  flush_input();
+  runtime.resetStats();
+  uint8_t types[8];
+
+  // 3 ms tap between two input samples, with contact bounce on both edges
+  uint32_t t = host::now_ms() + 11;
+  host::at(t, [] { host::set_pin(BTN_SELECT, LOW); });
+  host::at(t + 1, [] { host::set_pin(BTN_SELECT, HIGH); });
+  host::at(t + 2, [] { host::set_pin(BTN_SELECT, LOW); });
+  host::at(t + 3, [] { host::set_pin(BTN_SELECT, HIGH); });
+  TEST_ASSERT_EQUAL(2, run_button_frames(5, types, 8));
+  TEST_ASSERT_EQUAL(NAV_SELECT, types[0]);
+  TEST_ASSERT_EQUAL(NAV_RELEASE, types[1]);
+
+  // Double press
+  t = host::now_ms() + 500;
+  host::at(t, [] { host::set_pin(BTN_SELECT, LOW); });
+  host::at(t + 80, [] { host::set_pin(BTN_SELECT, HIGH); });
+  host::at(t + 200, [] { host::set_pin(BTN_SELECT, LOW); });
+  host::at(t + 280, [] { host::set_pin(BTN_SELECT, HIGH); });
+  TEST_ASSERT_EQUAL(5, run_button_frames(45, types, 8));
+  TEST_ASSERT_EQUAL(NAV_SELECT, types[2]);
+  TEST_ASSERT_EQUAL(NAV_DOUBLE_PRESS, types[3]);
+
+  // Long press is reported while still held
+  t = host::now_ms() + 500;
+  host::at(t, [] { host::set_pin(BTN_SELECT, LOW); });
+  host::at(t + 1200, [] { host::set_pin(BTN_SELECT, HIGH); });
+  TEST_ASSERT_EQUAL(3, run_button_frames(90, types, 8));
+  TEST_ASSERT_EQUAL(NAV_SELECT, types[0]);
+  TEST_ASSERT_EQUAL(NAV_LONG_PRESS, types[1]);
+  TEST_ASSERT_EQUAL(NAV_RELEASE, types[2]);
+
+  printf("[bench] %-18s tap_3ms=seen  max_edge_to_ui_ms=%u\n",
+         "button_events", runtime.getMaxInputLatency());
+  TEST_ASSERT_TRUE(runtime.getMaxInputLatency() <= RENDER_PERIOD_MS);
+}
+
+// Forty access points spread over channels 1-11; AP 5 is open
+static void add_office_aps() {
+  host::access_points.clear();
+  char name[33];
+  for (int i = 0; i < 40; i++) {
+    snprintf(name, sizeof(name), "Office-AP-%02d-Shared-Workspace", i);
+    wifi_auth_mode_t auth = (i == 5) ? WIFI_AUTH_OPEN : WIFI_AUTH_WPA2_PSK;
+    host::access_points.push_back(host::make_ap(name, i, 1 + (i % 11), -40 - i, auth));
+  }
+}
+
+// Channel-by-channel scan: first results against the full sweep
+void test_progressive_scan() {
+  add_office_aps();
+  bench_begin();
+  WiFiSelector selector(&display, &pref);
+
+  selector.startScan();
+  uint32_t first_ms = host::now_ms();
+  std::vector<NetworkInfo> first = selector.waitForScan(true);
+  first_ms = host::now_ms() - first_ms;
+  TEST_ASSERT_TRUE(selector.isScanning());
+  TEST_ASSERT_EQUAL(4, (int)first.size());  // Channel 1 only
+
+  std::vector<NetworkInfo> all = selector.waitForScan();
+  uint32_t full_ms = host::now_ms();
+  TEST_ASSERT_EQUAL(40, (int)all.size());
+  TEST_ASSERT_EQUAL(100, selector.getScanProgress());
+
+  // Non-overlapping channels with a shorter dwell
+  static const uint8_t channels[] = {1, 6, 11};
+  uint32_t t0 = host::now_ms();
+  std::vector<NetworkInfo> subset = selector.scanNetworks(ScanConfig(channels, 3, 120));
+  uint32_t subset_ms = host::now_ms() - t0;
+  TEST_ASSERT_EQUAL(11, (int)subset.size());
+
+  printf("[bench] %-18s first_results_ms=%-6u full_scan_ms=%-6u ch_1_6_11_ms=%u\n",
+         "progressive_scan", first_ms, full_ms, subset_ms);
+  TEST_ASSERT_TRUE(first_ms < full_ms / 4);
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+}
+
+// Dense office: 72 access points, several per SSID, kept to the top 16
+void test_scan_collector() {
+  host::access_points.clear();
+  char name[33];
+  for (int i = 0; i < 72; i++) {
+    snprintf(name, sizeof(name), "Floor-%02d", i % 24);   // Three APs per SSID
+    host::access_points.push_back(host::make_ap(name, i, 1 + (i % 13), -30 - (i * 7) % 61));
+  }
+  bench_begin();
+  WiFiSelector selector(&display, &pref);
+
+  ScanConfig config;
+  config.max_results = 16;
+  selector.startScan(config);
+  uint32_t allocs = host::alloc_count;
+  while (selector.isScanning()) {
+    selector.pollScan();
+    runtime.waitFrame();
+  }
+  allocs = host::alloc_count - allocs;
+  TEST_ASSERT_EQUAL(0, (int)WiFi.getScanRecordCount());  // Driver list freed after the last pass
+  const std::vector<NetworkInfo>& kept = selector.getScanResults();
+  const ScanCollector& collector = selector.getScanCollector();
+
+  // Reference: strongest AP of each SSID, strongest SSIDs first
+  struct Best { int8_t rssi; uint8_t id; uint8_t channel; };
+  Best best[24];
+  for (int s = 0; s < 24; s++) best[s] = {-128, 0, 0};
+  for (const host::AccessPoint& ap : host::access_points) {
+    int s = atoi(ap.ssid.c_str() + 6);
+    if (ap.rssi > best[s].rssi) best[s] = {(int8_t)ap.rssi, ap.bssid[5], ap.channel};
+  }
+
+  TEST_ASSERT_EQUAL(16, (int)kept.size());
+  for (size_t i = 0; i < kept.size(); i++) {
+    if (i > 0) TEST_ASSERT_TRUE(kept[i - 1].rssi >= kept[i].rssi);
+    const Best& b = best[atoi(kept[i].ssid + 6)];
+    TEST_ASSERT_EQUAL(b.rssi, kept[i].rssi);
+    TEST_ASSERT_EQUAL(b.id, kept[i].bssid[5]);
+    TEST_ASSERT_EQUAL(b.channel, kept[i].channel);
+  }
+  int at_least_kept = 0;
+  for (int s = 0; s < 24; s++) {
+    if (best[s].rssi >= kept.back().rssi) at_least_kept++;
+  }
+  TEST_ASSERT_EQUAL(16, at_least_kept);
+
+  printf("[bench] %-18s aps=%-3u kept=%-3u merged=%-3u dropped=%-3u allocs=%u sizeof(NetworkInfo)=%u\n",
+         "scan_collector", collector.getSeenCount(), (unsigned)kept.size(), collector.getMergedCount(),
+         collector.getDroppedCount(), allocs, (unsigned)sizeof(NetworkInfo));
+  TEST_ASSERT_EQUAL_UINT32(72, collector.getSeenCount());
+  TEST_ASSERT_EQUAL_UINT32(0, allocs);  // Storage reserved when the selector was built
+}
+
+// Stepping through forty networks: rows rendered and bus bytes per step
+void test_network_list() {
+  add_office_aps();
+  bench_begin();
+  WiFiSelector selector(&display, &pref);
+  std::vector<NetworkInfo> networks = selector.scanNetworks();
+  TEST_ASSERT_EQUAL(40, (int)networks.size());
+
+  NetworkListView view(&display);
+  display.clearDisplay();
+  view.setNetworks(networks);
+  view.draw();
+  TEST_ASSERT_EQUAL_UINT32(LIST_ROWS, view.getRowsRendered());
+
+  // Within the first screen only the highlight moves
+  view.resetStats();
+  for (int i = 1; i < LIST_ROWS; i++) {
+    view.move(1);
+    view.draw();
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, view.getRowsRendered());
+  TEST_ASSERT_EQUAL(0, view.getTop());
+
+  // Past it, each step brings in one new row; the rest are cache copies
+  view.resetStats();
+  uint32_t before = Wire.getBytesOnBus();
+  int steps = 40 - LIST_ROWS;
+  for (int i = 0; i < steps; i++) {
+    view.move(1);
+    view.draw();
+  }
+  uint32_t step_bytes = Wire.getBytesOnBus() - before;
+  TEST_ASSERT_EQUAL(39, view.getSelected());
+  TEST_ASSERT_EQUAL(40 - LIST_ROWS, view.getTop());
+  TEST_ASSERT_EQUAL_UINT32(steps, view.getRowsRendered());
+  printf("[bench] %-18s rows=%d rows_rendered/step=%-5.2f rows_copied/step=%-5.2f i2c_bytes/step=%.1f\n",
+         "network_list", LIST_ROWS, (double)view.getRowsRendered() / steps,
+         (double)view.getRowsCopied() / steps, (double)step_bytes / steps);
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+
+  // Wrapping to the top renders the first screen again, at most
+  view.resetStats();
+  view.move(1);
+  view.draw();
+  TEST_ASSERT_EQUAL(0, view.getTop());
+  TEST_ASSERT_TRUE(view.getRowsRendered() <= LIST_ROWS);
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+}
+
+// Full selection flow: scan, navigate five networks down, select, connect
+void test_network_selection() {
+  add_office_aps();
+
+  BenchStart start = bench_begin();
+  WiFiSelector selector(&display, &pref);
+  std::vector<NetworkInfo> networks = selector.scanNetworks();
+  TEST_ASSERT_EQUAL(40, (int)networks.size());
+
+  uint32_t t = host::now_ms() + 1000;
+  for (int step = 0; step < 5; step++, t += 400) {
+    host::at(t, [] { host::analog_values[POT_Y_PIN] = 4000; });
+    host::at(t + 200, [] { host::analog_values[POT_Y_PIN] = POT_CENTER; });
+  }
+  host::at(t + 500, [] { host::set_pin(BTN_SELECT, LOW); });
+  host::at(t + 600, [] { host::set_pin(BTN_SELECT, HIGH); });
+
+  TEST_ASSERT_TRUE(selector.selectAndConnectNetwork(networks));
+  bench_report("network_selection", start, display.getFlushCount() + display.getSkippedCount());
+
+  // Strongest first, so the sixth entry is AP 5
+  TEST_ASSERT_EQUAL_STRING("Office-AP-05-Shared-Workspace", WiFi.SSID().c_str());
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+}
+
+// Idle list screen: frames skipped, bus silent, time handed to sleep
+static uint32_t idle_bus_bytes[2];
+
+void test_frame_scheduler() {
+  host::access_points.clear();
+  host::access_points.push_back(host::make_ap("Home", 1, 6, -45, WIFI_AUTH_OPEN));
+  host::access_points.push_back(host::make_ap("Lab", 2, 1, -60));
+  host::access_points.push_back(host::make_ap("Office", 3, 11, -70));
+  WiFi.disconnect();
+
+  bench_begin();
+  WiFiSelector selector(&display, &pref);
+  std::vector<NetworkInfo> networks = selector.scanNetworks();
+
+  // Five idle seconds on the list, then pick Home
+  uint32_t t = host::now_ms();
+  host::at(t + 1000, [] { idle_bus_bytes[0] = Wire.getBytesOnBus(); });
+  host::at(t + 6000, [] { idle_bus_bytes[1] = Wire.getBytesOnBus(); });
+  host::at(t + 6100, [] { host::set_pin(BTN_SELECT, LOW); });
+  host::at(t + 6200, [] { host::set_pin(BTN_SELECT, HIGH); });
+
+  runtime.resetStats();
+  TEST_ASSERT_TRUE(selector.selectAndConnectNetwork(networks));
+  uint32_t frames = runtime.getFrameCount();
+  printf("[bench] %-18s frames=%-5u rendered=%-4u skipped=%-5u idle_ms=%-6u idle_i2c_bytes=%u\n",
+         "frame_scheduler", frames, runtime.getRenderedCount(), runtime.getSkippedCount(),
+         runtime.getIdleMs(), idle_bus_bytes[1] - idle_bus_bytes[0]);
+  TEST_ASSERT_EQUAL_UINT32(0, idle_bus_bytes[1] - idle_bus_bytes[0]);
+  TEST_ASSERT_TRUE(runtime.getRenderedCount() < 10);
+  TEST_ASSERT_TRUE(runtime.getSkippedCount() > 250);
+  TEST_ASSERT_TRUE(runtime.getIdleMs() > 5000);
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+}
+
+// Boot with saved credentials: scan path against the cached BSSID/channel
+void test_fast_reconnect() {
+  add_office_aps();
+  host::nvs.clear();
+  pref.begin("wifi-creds");
+  pref.putString("ssid", "Office-AP-07-Shared-Workspace");
+  pref.putString("password", "password");
+  pref.end();
+
+  // First boot: nothing cached yet, so scan, then connect and cache the AP
+  WiFi.disconnect();
+  bench_begin();
+  WiFiSelector first(&display, &pref);
+  TEST_ASSERT_TRUE(!first.connectFast());
+  first.startScan();
+  TEST_ASSERT_TRUE(first.connectWithSavedCredentials(first.waitForScan()));
+  uint32_t scan_ms = host::now_ms();
+
+  // Second boot goes straight to the cached AP
+  WiFi.disconnect();
+  bench_begin();
+  uint32_t scans = host::wifi_scan_count;
+  WiFiSelector second(&display, &pref);
+  TEST_ASSERT_TRUE(second.connectFast());
+  uint32_t fast_ms = host::now_ms();
+  TEST_ASSERT_EQUAL_UINT32(scans, host::wifi_scan_count);
+  TEST_ASSERT_EQUAL_STRING("Office-AP-07-Shared-Workspace", WiFi.SSID().c_str());
+
+  // AP moved to another channel: fail fast and leave the scan path to it
+  host::access_points[7].channel = 11;
+  WiFi.disconnect();
+  bench_begin();
+  WiFiSelector third(&display, &pref);
+  TEST_ASSERT_TRUE(!third.connectFast());
+  uint32_t fallback_ms = host::now_ms();
+  TEST_ASSERT_TRUE(fallback_ms < FAST_CONNECT_TIMEOUT_MS);
+
+  printf("[bench] %-18s scan_path_ms=%-6u fast_path_ms=%-6u stale_cache_ms=%u\n",
+         "fast_reconnect", scan_ms, fast_ms, fallback_ms);
+  TEST_ASSERT_TRUE(fast_ms * 4 < scan_ms);
+}
+
+// Device moving between sites with several remembered networks
+void test_credential_store() {
+  host::access_points.clear();
+  host::access_points.push_back(host::make_ap("Home", 1, 6, -70));
+  host::access_points.push_back(host::make_ap("Office", 2, 1, -55));
+  host::access_points.push_back(host::make_ap("Office", 3, 11, -48));  // Second AP, same SSID
+  host::access_points.push_back(host::make_ap("Cafe", 4, 3, -60));
+  host::nvs.clear();
+  WiFi.disconnect();
+  bench_begin();
+
+  // Remember Home, Lab, Office; Lab is out of range here
+  {
+    CredentialStore store(&pref);
+    const uint8_t bssid[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x09};
+    store.recordSuccess("Home", "password", bssid, 6, -70);
+    store.recordSuccess("Lab", "password", bssid, 9, -50);
+    store.recordSuccess("Office", "password", bssid, 1, -55);
+  }
+
+  WiFiSelector selector(&display, &pref);
+  uint32_t reads = host::nvs_reads;
+  TEST_ASSERT_EQUAL(3, selector.getCredentialStore().count());
+  TEST_ASSERT_EQUAL_UINT32(reads + 1, host::nvs_reads);  // One blob read
+
+  // Office has the strongest AP and the freshest success
+  ScanSet scan;
+  std::vector<NetworkInfo> networks = selector.scanNetworks();
+  for (size_t i = 0; i < networks.size(); i++) {
+    scan.add(networks[i].ssid, networks[i].rssi, i);
+  }
+  TEST_ASSERT_EQUAL(3, scan.size());
+  Candidate ranked[CRED_STORE_MAX];
+  TEST_ASSERT_EQUAL(2, selector.getCredentialStore().rank(scan, ranked, CRED_STORE_MAX));
+  TEST_ASSERT_EQUAL_STRING("Office", networks[ranked[0].network].ssid);
+  TEST_ASSERT_EQUAL(-48, networks[ranked[0].network].rssi);
+  TEST_ASSERT_EQUAL_STRING("Home", networks[ranked[1].network].ssid);
+
+  // Office password changed: fall through to Home and demote Office
+  host::access_points[1].password = "rotated";
+  host::access_points[2].password = "rotated";
+  TEST_ASSERT_TRUE(selector.connectWithSavedCredentials(networks));
+  TEST_ASSERT_EQUAL_STRING("Home", WiFi.SSID().c_str());
+
+  const SavedNetwork* office = selector.getCredentialStore().get(selector.getCredentialStore().find("Office"));
+  TEST_ASSERT_EQUAL(1, office->fail_count);
+  TEST_ASSERT_EQUAL(1, selector.getCredentialStore().rank(scan, ranked, 1));
+  TEST_ASSERT_EQUAL_STRING("Home", networks[ranked[0].network].ssid);
+
+  // Store survives a reboot
+  WiFiSelector rebooted(&display, &pref);
+  TEST_ASSERT_EQUAL(3, rebooted.getCredentialStore().count());
+  TEST_ASSERT_EQUAL_STRING("Home", rebooted.getCredentialStore().mostRecent()->ssid);
+}
+
+// Event-driven connect against the old delay(500) status() loop
+void test_connection_engine() {
+  host::access_points.clear();
+  host::access_points.push_back(host::make_ap("Home", 1, 6, -60));
+  host::wifi_connect_ms = 1234;  // Link comes up between two 500 ms polls
+  WiFi.disconnect();
+  bench_begin();
+
+  // Previous waitForConnection(): status() every 500 ms
+  WiFi.begin("Home", "password");
+  uint32_t t0 = host::now_ms();
+  while (WiFi.status() != WL_CONNECTED && host::now_ms() - t0 < WIFI_TIMEOUT_MS) {
+    delay(500);
+  }
+  uint32_t polled_ms = host::now_ms() - t0;
+  WiFi.disconnect();
+
+  ConnectionEngine engine;
+  t0 = host::now_ms();
+  TEST_ASSERT_TRUE(engine.connect("Home", "password"));
+  TEST_ASSERT_EQUAL(CONN_CONNECTING, engine.poll());  // Returns at once
+  while (engine.poll() == CONN_CONNECTING) {
+    delay(1);
+  }
+  uint32_t event_ms = host::now_ms() - t0;
+  TEST_ASSERT_EQUAL(CONN_CONNECTED, engine.getState());
+  TEST_ASSERT_TRUE(event_ms <= host::wifi_connect_ms + 1);
+  WiFi.disconnect();
+
+  // Wrong password: the old loop ran into the timeout
+  t0 = host::now_ms();
+  engine.connect("Home", "hunter2");
+  while (engine.poll() == CONN_CONNECTING) {
+    delay(1);
+  }
+  uint32_t auth_fail_ms = host::now_ms() - t0;
+  TEST_ASSERT_EQUAL(CONN_AUTH_FAILED, engine.getState());
+  TEST_ASSERT_TRUE(auth_fail_ms < WIFI_TIMEOUT_MS / 4);
+  // Transient handshake reasons are left to the driver's own retries
+  TEST_ASSERT_FALSE(ConnectionEngine::isAuthFailure(WIFI_REASON_AUTH_EXPIRE));
+  TEST_ASSERT_FALSE(ConnectionEngine::isAuthFailure(WIFI_REASON_HANDSHAKE_TIMEOUT));
+
+  engine.connect("Elsewhere", "password");
+  while (engine.poll() == CONN_CONNECTING) {
+    delay(1);
+  }
+  TEST_ASSERT_EQUAL(CONN_NO_AP, engine.getState());
+  engine.end();
+
+  printf("[bench] %-18s polled_ms=%-6u event_ms=%-6u wrong_password_ms=%-6u (timeout %u)\n",
+         "connection_engine", polled_ms, event_ms, auth_fail_ms, WIFI_TIMEOUT_MS);
+  host::wifi_connect_ms = 1500;
+}
+
+// UI frames and input while the network side scans and connects
+void test_task_runtime() {
+  // Queue wrap-around and overflow accounting
+  SpscQueue<int, 4> queue;
+  int value = 0;
+  for (int i = 0; i < 10; i++) {
+    TEST_ASSERT_TRUE(queue.push(i));
+    TEST_ASSERT_TRUE(queue.pop(value));
+    TEST_ASSERT_EQUAL(i, value);
+  }
+  for (int i = 0; i < 5; i++) queue.push(i);
+  TEST_ASSERT_EQUAL(4, (int)queue.size());
+  TEST_ASSERT_EQUAL_UINT32(1, queue.getDropped());
+  TEST_ASSERT_TRUE(queue.popLatest(value));
+  TEST_ASSERT_EQUAL(3, value);
+
+  add_office_aps();
+  bench_begin();
+  WiFiSelector selector(&display, &pref);
+  init_controls();
+  flush_input();
+
+  // Nudge the Y pot every 300 ms for the whole scan
+  for (uint32_t t = 100; t < 4000; t += 300) {
+    host::at(t, [] { host::analog_values[POT_Y_PIN] = 4000; });
+    host::at(t + 150, [] { host::analog_values[POT_Y_PIN] = POT_CENTER; });
+  }
+
+  selector.startScan();
+  runtime.resetStats();
+  int moves = 0;
+  InputEvent event;
+  while (selector.isScanning()) {
+    selector.pollScan();
+    while (next_input(event)) {
+      if (event.type == NAV_DOWN) moves++;
+    }
+    selector.drawScanProgress();
+    runtime.waitFrame();
+  }
+  uint32_t frames = runtime.getFrameCount();
+  uint32_t frame_ms = host::now_ms() / (frames ? frames : 1);
+
+  printf("[bench] %-18s frames=%-5u ms/frame=%-4u overruns=%-3u max_input_latency_ms=%u\n",
+         "task_runtime", frames, frame_ms, runtime.getOverrunCount(), runtime.getMaxInputLatency());
+  TEST_ASSERT_EQUAL(13, moves);
+  TEST_ASSERT_TRUE(runtime.getMaxInputLatency() <= RENDER_PERIOD_MS);
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+}
+
+// Double buffering: frames reach the panel whole and in order, and the
+// transfer overlaps the next frame's rendering
+static PartialDisplay async_display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET_PIN);
+
+// Every column changes, so each frame is a full-screen transfer
+static void draw_full_frame(PartialDisplay& disp, int frame) {
+  disp.fillRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (frame & 1) ? SSD1306_WHITE : SSD1306_BLACK);
+  disp.setTextColor(SSD1306_INVERSE);
+  disp.setCursor(0, (frame % 8) * 8);
+  disp.print(frame);
+}
+
+// Average frame time of draw + display() with a fixed render cost. The host
+// has one thread, so the transfer task on the other core is modeled here: it
+// sends the frame right after the hand-off without holding up the loop, and
+// the bus stays busy for the time those bytes take on the wire.
+static uint32_t frame_time_us(PartialDisplay& disp, uint32_t clock_hz, uint32_t render_us, int frames) {
+  disp.setBusClock(clock_hz);
+  disp.invalidate();  // The other driver drew on the panel last
+  uint64_t start = host::clock_us;
+  uint64_t bus_free = start;
+
+  for (int frame = 0; frame < frames; frame++) {
+    draw_full_frame(disp, frame);
+    host::advance_us(render_us);
+
+    if (!disp.isAsync()) {
+      disp.display();
+      continue;
+    }
+    if (host::clock_us < bus_free) {
+      host::advance_us(bus_free - host::clock_us);  // Hand-off waits for the bus
+    }
+    disp.display();
+    uint64_t bus_before = Wire.getBusTimeUs();
+    host::model_bus_time = false;
+    disp.serviceTransfer();
+    host::model_bus_time = true;
+    bus_free = host::clock_us + (Wire.getBusTimeUs() - bus_before);
+  }
+  if (host::clock_us < bus_free) {
+    host::advance_us(bus_free - host::clock_us);
+  }
+  return (host::clock_us - start) / frames;
+}
+
+void test_async_display() {
+  bench_begin();
+  async_display.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS);
+  TEST_ASSERT_TRUE(async_display.beginAsync());
+  static uint8_t handed_off[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+
+  // Drawing after the hand-off lands in the back buffer, not in the frame
+  // being sent
+  draw_full_frame(async_display, 1);
+  async_display.display();
+  memcpy(handed_off, async_display.getBuffer(), sizeof(handed_off));
+  TEST_ASSERT_TRUE(async_display.isTransferPending());
+  draw_full_frame(async_display, 2);
+  TEST_ASSERT_TRUE(async_display.serviceTransfer());
+  TEST_ASSERT_TRUE(panel.matches(handed_off));
+  TEST_ASSERT_FALSE(panel.matches(async_display.getBuffer()));
+
+  // Back to back frames: the second hand-off sends the first frame, then
+  // queues its own
+  async_display.display();
+  memcpy(handed_off, async_display.getBuffer(), sizeof(handed_off));
+  draw_full_frame(async_display, 3);
+  async_display.resetStats();
+  async_display.display();
+  TEST_ASSERT_EQUAL_UINT32(1, async_display.getWaitCount());
+  TEST_ASSERT_EQUAL_UINT32(1, async_display.getFlushCount());
+  TEST_ASSERT_TRUE(panel.matches(handed_off));
+  async_display.waitTransfer();
+  TEST_ASSERT_EQUAL_UINT32(2, async_display.getFlushCount());
+  TEST_ASSERT_TRUE(panel.matches(async_display.getBuffer()));
+
+  // Retained drawing continues from the frame just handed off
+  async_display.fillRect(0, 0, 8, 8, SSD1306_INVERSE);
+  async_display.displayRect(0, 0, 8, 8);
+  async_display.waitTransfer();
+  TEST_ASSERT_TRUE(panel.matches(async_display.getBuffer()));
+
+  // Frame time with a 15 ms render at fast mode and fast mode plus
+  const uint32_t render_us = 15000;
+  for (uint32_t clock_hz : {400000u, 1000000u}) {
+    uint64_t bus_before = Wire.getBusTimeUs();
+    uint32_t sync_us = frame_time_us(display, clock_hz, render_us, 20);
+    uint32_t transfer_us = (Wire.getBusTimeUs() - bus_before) / 20;
+    uint32_t async_us = frame_time_us(async_display, clock_hz, render_us, 20);
+
+    printf("[bench] async_%-12u render_us=%-6u transfer_us=%-6u sync_us/frame=%-6u async_us/frame=%u\n",
+           clock_hz, render_us, transfer_us, sync_us, async_us);
+    TEST_ASSERT_UINT32_WITHIN(100, render_us + transfer_us, sync_us);
+    // Plus filling the pipeline: one render or transfer per run
+    TEST_ASSERT_UINT32_WITHIN(min(render_us, transfer_us) / 20 + 100, max(render_us, transfer_us), async_us);
+  }
+  async_display.waitTransfer();
+  TEST_ASSERT_TRUE(panel.matches(async_display.getBuffer()));
+  display.setBusClock(100000);
+}
+
+// Duty cycle: cold boot through the scan, then timer wakes from RTC memory
+void test_sleep_cycle() {
+  add_office_aps();
+  host::nvs.clear();
+  pref.begin("wifi-creds");
+  pref.putString("ssid", "Office-AP-07-Shared-Workspace");
+  pref.putString("password", "password");
+  pref.end();
+
+  // Cold boot: no RTC state, full scan path
+  WiFi.disconnect();
+  bench_begin();
+  SleepCycle cycle;
+  TEST_ASSERT_FALSE(cycle.begin());
+  TEST_ASSERT_FALSE(cycle.hasNetwork());
+  WiFiSelector first(&display, &pref);
+  first.startScan();
+  std::vector<NetworkInfo> networks = first.waitForScan();
+  cycle.recordScan(networks);
+  TEST_ASSERT_TRUE(first.connectWithSavedCredentials(networks));
+  cycle.recordConnected();
+  cycle.recordConnection(*first.getCredentialStore().mostRecent());
+  cycle.sleep();
+  uint32_t cold_ms = cycle.getLastAwakeMs();
+  TEST_ASSERT_EQUAL_UINT32(SLEEP_DURATION_SECONDS, cycle.getSleepSeconds());
+
+  // Timer wakes: millis() restarts, RAM is gone, RTC memory is not
+  uint32_t wake_ms = 0;
+  uint32_t connect_ms = 0;
+  for (int wake = 0; wake < 3; wake++) {
+    WiFi.disconnect();
+    bench_begin();
+    uint32_t nvs_reads = host::nvs_reads;
+    uint32_t scans = host::wifi_scan_count;
+
+    SleepCycle woken;
+    TEST_ASSERT_TRUE(woken.begin());
+    TEST_ASSERT_TRUE(woken.hasNetwork());
+    TEST_ASSERT_NOT_NULL(woken.getStaticIp());
+    WiFiSelector selector(&display, &pref);
+    TEST_ASSERT_TRUE(selector.connectFast(woken.getNetwork(), woken.getStaticIp()));
+    woken.recordConnected();
+    connect_ms = woken.getConnectMs();
+    woken.sleep();
+    wake_ms = woken.getLastAwakeMs();
+
+    TEST_ASSERT_EQUAL_UINT32(nvs_reads, host::nvs_reads);
+    TEST_ASSERT_EQUAL_UINT32(scans, host::wifi_scan_count);
+    TEST_ASSERT_EQUAL_STRING("Office-AP-07-Shared-Workspace", WiFi.SSID().c_str());
+    TEST_ASSERT_EQUAL_STRING("192.168.1.42", WiFi.localIP().toString().c_str());
+    TEST_ASSERT_EQUAL_UINT32(wake + 2, woken.getWakeCount());
+  }
+
+  SleepCycle report;
+  TEST_ASSERT_TRUE(report.begin());
+  TEST_ASSERT_EQUAL_UINT32(wake_ms, report.getLastAwakeMs());
+  TEST_ASSERT_EQUAL_UINT32(connect_ms, report.getLastConnectMs());
+  TEST_ASSERT_EQUAL_UINT32(cold_ms + 3 * wake_ms, report.getTotalAwakeMs());
+  TEST_ASSERT_EQUAL_UINT8(WAKE_SCAN_SUMMARY, report.getScanCount());
+  TEST_ASSERT_EQUAL_UINT32(networks.size(), report.getScanTotal());
+  TEST_ASSERT_EQUAL_STRING(networks[0].ssid, report.getScan()[0].ssid);
+
+  printf("[bench] %-18s cold_awake_ms=%-6u wake_awake_ms=%-5u wake_to_ip_ms=%u\n",
+         "sleep_cycle", cold_ms, wake_ms, connect_ms);
+  TEST_ASSERT_TRUE(wake_ms < 1000);
+  TEST_ASSERT_TRUE(wake_ms * 4 < cold_ms);
+
+  // AP gone: the stored network is dropped and the next wake starts over
+  host::access_points[7].channel = 11;
+  WiFi.disconnect();
+  bench_begin();
+  WiFiSelector stale(&display, &pref);
+  TEST_ASSERT_FALSE(stale.connectFast(report.getNetwork(), report.getStaticIp()));
+  report.forgetNetwork();
+  report.sleep();
+  SleepCycle after;
+  TEST_ASSERT_TRUE(after.begin());
+  TEST_ASSERT_FALSE(after.hasNetwork());
+  TEST_ASSERT_NULL(after.getStaticIp());
+}
+
+// Telemetry: batched rows over one keep-alive connection against per-reading
+// JSON requests, then retries and readings kept across wakes
+static int uplink_failures_left;
+
+// Readings the loopback server received, in order
+static std::vector<Reading> received_readings() {
+  std::vector<Reading> readings;
+  for (const host::HttpRequest& request : host::http_requests) {
+    unsigned long base;
+    const char* row = request.body.c_str();
+    if (sscanf(row, "v1,%lu\n", &base) != 1) continue;
+    row = strchr(row, '\n') + 1;
+    long delta, value;
+    unsigned sensor;
+    while (sscanf(row, "%ld,%u,%ld\n", &delta, &sensor, &value) == 3) {
+      readings.push_back({(uint32_t)(base + delta), (uint16_t)sensor, (int32_t)value});
+      row = strchr(row, '\n') + 1;
+    }
+  }
+  return readings;
+}
+
+void test_uplink() {
+  const int count = 24;
+  host::reset(POT_CENTER);
+  host::http_reset();
+
+  // Reference: one JSON request per reading, new connection each time
+  HTTPClient naive;
+  naive.setReuse(false);
+  uint64_t start = host::clock_us;
+  for (int i = 0; i < count; i++) {
+    char json[64];
+    int length = snprintf(json, sizeof(json), "{\"time\":%d,\"sensor\":%d,\"value\":%d}",
+                          1700000000 + i * 10, 1 + i % 3, -40 - i);
+    naive.begin(UPLINK_URL);
+    naive.addHeader("Content-Type", "application/json");
+    naive.POST((uint8_t*)json, length);
+    naive.end();
+  }
+  uint32_t naive_ms = (host::clock_us - start) / 1000;
+  uint32_t naive_requests = host::http_requests.size();
+  uint32_t naive_connections = host::http_connections;
+  uint32_t naive_bytes = host::http_bytes;
+
+  host::http_reset();
+  Uplink uplink(UPLINK_URL);
+  uplink.clear();
+  for (int i = 0; i < count; i++) {
+    uplink.add(1700000000 + i * 10, 1 + i % 3, -40 - i);
+  }
+  start = host::clock_us;
+  TEST_ASSERT_TRUE(uplink.flush());
+  uint32_t batch_ms = (host::clock_us - start) / 1000;
+
+  printf("[bench] %-18s readings=%-3d requests/reading=%.2f/%.3f conns=%u/%u bytes/reading=%.1f/%.1f radio_ms=%u/%u\n",
+         "uplink", count, (double)naive_requests / count, (double)host::http_requests.size() / count,
+         naive_connections, host::http_connections, (double)naive_bytes / count,
+         (double)host::http_bytes / count, naive_ms, batch_ms);
+  TEST_ASSERT_EQUAL_UINT32(1, host::http_requests.size());
+  TEST_ASSERT_EQUAL_UINT32(0, uplink.pending());
+  TEST_ASSERT_TRUE(host::http_bytes * 4 < naive_bytes);
+  std::vector<Reading> readings = received_readings();
+  TEST_ASSERT_EQUAL(count, (int)readings.size());
+  for (int i = 0; i < count; i++) {
+    TEST_ASSERT_EQUAL_UINT32(1700000000 + i * 10, readings[i].time);
+    TEST_ASSERT_EQUAL(1 + i % 3, readings[i].sensor);
+    TEST_ASSERT_EQUAL(-40 - i, readings[i].value);
+  }
+
+  // More than a batch: several POSTs, still one connection
+  for (int i = 0; i < UPLINK_QUEUE_MAX; i++) {
+    uplink.add(1700001000 + i, 1, i);
+  }
+  TEST_ASSERT_TRUE(uplink.flush());
+  TEST_ASSERT_EQUAL_UINT32(1 + UPLINK_QUEUE_MAX / UPLINK_BATCH_MAX, host::http_requests.size());
+  TEST_ASSERT_EQUAL_UINT32(1, host::http_connections);
+
+  // Server busy twice: retried after 250 and 500 ms on the same connection
+  host::http_requests.clear();
+  uplink_failures_left = 2;
+  host::http_handler = [](const host::HttpRequest&) {
+    return uplink_failures_left-- > 0 ? HTTP_CODE_SERVICE_UNAVAILABLE : HTTP_CODE_OK;
+  };
+  uplink.add(1700002000, 2, 7);
+  start = host::clock_us;
+  TEST_ASSERT_TRUE(uplink.flush());
+  TEST_ASSERT_EQUAL_UINT32(3, host::http_requests.size());
+  TEST_ASSERT_TRUE(host::clock_us - start >= (UPLINK_BACKOFF_MS * 3) * 1000ULL);
+  TEST_ASSERT_EQUAL_UINT32(1, host::http_connections);
+
+  // Server down: the wake gives up, the readings wait in RTC memory
+  host::http_handler = nullptr;
+  host::http_server_up = false;
+  uplink.resetStats();
+  uplink.add(1700003000, 3, -61);
+  uplink.add(1700003010, 3, -63);
+  TEST_ASSERT_FALSE(uplink.flush());
+  TEST_ASSERT_EQUAL_UINT32(UPLINK_MAX_ATTEMPTS, uplink.getFailureCount());
+  TEST_ASSERT_EQUAL(2, uplink.pending());
+  uplink.close();
+
+  host::http_reset();
+  Uplink next_wake(UPLINK_URL);
+  TEST_ASSERT_EQUAL(2, next_wake.pending());
+  TEST_ASSERT_TRUE(next_wake.flush());
+  readings = received_readings();
+  TEST_ASSERT_EQUAL(2, (int)readings.size());
+  TEST_ASSERT_EQUAL(-63, readings[1].value);
+
+  // Full queue drops the oldest
+  next_wake.clear();
+  for (int i = 0; i < UPLINK_QUEUE_MAX + 4; i++) {
+    next_wake.add(i, 1, i);
+  }
+  TEST_ASSERT_EQUAL_UINT32(4, next_wake.getDroppedCount());
+  host::http_reset();
+  TEST_ASSERT_TRUE(next_wake.flush());
+  TEST_ASSERT_EQUAL(4, received_readings()[0].value);
+}
+
+void test_rtc_time() {
+  const uint32_t epoch = 1760000000;  // 2025-10-09
+  host::reset(POT_CENTER);
+  host::ntp_epoch = epoch;
+  host::ntp_syncs = 0;
+  host::FakeRtc rtc;
+  rtc.set(epoch);
+  Wire.attach(RTC_I2C_ADDRESS, &rtc);
+
+  // Calendar conversion matches the C library
+  for (uint32_t t : {0u, 951782400u, 1709164800u, epoch, 4102444799u}) {
+    int year, month, day, hour, minute, second, weekday;
+    TimeService::fromEpoch(t, year, month, day, hour, minute, second, weekday);
+    time_t c_time = t;
+    struct tm fields;
+    gmtime_r(&c_time, &fields);
+    TEST_ASSERT_EQUAL(fields.tm_year + 1900, year);
+    TEST_ASSERT_EQUAL(fields.tm_mon + 1, month);
+    TEST_ASSERT_EQUAL(fields.tm_mday, day);
+    TEST_ASSERT_EQUAL(fields.tm_wday, weekday);
+    TEST_ASSERT_EQUAL_UINT32(t, TimeService::toEpoch(year, month, day, hour, minute, second));
+  }
+
+  // Power-on: the RTC gives the time at once, one network sync starts the schedule
+  TimeService first;
+  uint64_t start = host::clock_us;
+  TEST_ASSERT_TRUE(first.begin());
+  uint64_t rtc_us = host::clock_us - start;
+  TEST_ASSERT_TRUE(first.isValid());
+  TEST_ASSERT_EQUAL_UINT32(epoch, first.now());
+  TEST_ASSERT_EQUAL_UINT32(0, host::ntp_syncs);
+  TEST_ASSERT_TRUE(first.needsSync());
+  start = host::clock_us;
+  TEST_ASSERT_TRUE(first.syncNetworkTime());
+  uint64_t ntp_us = host::clock_us - start;
+  TEST_ASSERT_EQUAL_UINT32(1, host::ntp_syncs);
+  TEST_ASSERT_EQUAL_UINT32(1, rtc.time_writes);
+
+  // Wakes within the interval: time from the RTC, no network time
+  for (int wake = 0; wake < 12; wake++) {
+    host::advance(SLEEP_DURATION_SECONDS * 1000);
+    TimeService woke;
+    TEST_ASSERT_TRUE(woke.begin());
+    TEST_ASSERT_FALSE(woke.needsSync());
+    TEST_ASSERT_EQUAL_UINT32(epoch + host::clock_us / 1000000, woke.now());
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, host::ntp_syncs);
+  printf("[bench] %-18s time_at_boot_us rtc=%llu ntp=%llu syncs/day=%u (was %u)\n", "rtc_time",
+         (unsigned long long)rtc_us, (unsigned long long)ntp_us, 24 / TIME_SYNC_HOURS,
+         86400 / SLEEP_DURATION_SECONDS);
+
+  // A day on a crystal 50 ppm fast: the sync measures the drift
+  rtc.setDrift(50);
+  host::advance(TIME_SYNC_HOURS * 3600000UL);
+  TimeService next_day;
+  TEST_ASSERT_TRUE(next_day.begin());
+  TEST_ASSERT_TRUE(next_day.needsSync());
+  TEST_ASSERT_TRUE(next_day.syncNetworkTime());
+  TEST_ASSERT_TRUE(next_day.getLastError() >= 3 && next_day.getLastError() <= 5);
+  TEST_ASSERT_FLOAT_WITHIN(15, 50, next_day.getDriftPpm());
+
+  // The day after, reads are corrected for it
+  host::advance(TIME_SYNC_HOURS * 3600000UL - 1000);
+  TimeService corrected;
+  TEST_ASSERT_TRUE(corrected.begin());
+  uint32_t network_now = epoch + host::clock_us / 1000000;
+  TEST_ASSERT_TRUE(rtc.now() - network_now >= 3);
+  TEST_ASSERT_UINT32_WITHIN(1, network_now, corrected.now());
+
+  // Backup battery gone: no valid time until the network provides it
+  rtc.losePower();
+  TimeService lost;
+  TEST_ASSERT_FALSE(lost.begin());
+  TEST_ASSERT_TRUE(lost.hasRtc());
+  TEST_ASSERT_FALSE(lost.isValid());
+  TEST_ASSERT_EQUAL_UINT32(0, lost.now());
+  TEST_ASSERT_TRUE(lost.needsSync());
+  TEST_ASSERT_TRUE(lost.syncNetworkTime());
+  TimeService restored;
+  TEST_ASSERT_TRUE(restored.begin());
+  TEST_ASSERT_UINT32_WITHIN(1, epoch + host::clock_us / 1000000, restored.now());
+
+  // DS1307: halted until the first sync starts its oscillator
+  host::FakeRtc ds1307(true);
+  ds1307.losePower();
+  Wire.attach(RTC_I2C_ADDRESS, &ds1307);
+  TimeService old_chip(&Wire, RTC_CHIP_DS1307);
+  TEST_ASSERT_FALSE(old_chip.begin());
+  TEST_ASSERT_TRUE(old_chip.syncNetworkTime());
+  TEST_ASSERT_EQUAL_UINT32(1, ds1307.time_writes);
+  host::advance(SLEEP_DURATION_SECONDS * 1000);
+  TimeService old_chip_wake(&Wire, RTC_CHIP_DS1307);
+  TEST_ASSERT_TRUE(old_chip_wake.begin());
+  TEST_ASSERT_EQUAL_UINT32(epoch + host::clock_us / 1000000, old_chip_wake.now());
+
+  // No RTC fitted: network time only
+  Wire.attach(RTC_I2C_ADDRESS, nullptr);
+  TimeService none;
+  TEST_ASSERT_FALSE(none.begin());
+  TEST_ASSERT_FALSE(none.hasRtc());
+  TEST_ASSERT_TRUE(none.needsSync());
+  TEST_ASSERT_TRUE(none.syncNetworkTime());
+  TEST_ASSERT_TRUE(none.isValid());
+
+  // Network unreachable: the sync fails and keeps no time
+  host::ntp_epoch = 0;
+  TimeService offline;
+  TEST_ASSERT_FALSE(offline.syncNetworkTime(500));
+  TEST_ASSERT_FALSE(offline.isValid());
+}
+
+struct ByteCapture : public Print {
+  std::vector<uint8_t> bytes;
+  using Print::write;
+  size_t write(uint8_t c) override {
+    bytes.push_back(c);
+    return 1;
+  }
+};
+
+// Events of one dump, read the way trace_decode.py reads them
+static std::vector<TraceEvent> parse_trace(const std::vector<uint8_t>& bytes, uint32_t& lost) {
+  TEST_ASSERT_TRUE(bytes.size() >= 15);
+  TEST_ASSERT_EQUAL_MEMORY(TRACE_DUMP_MAGIC, bytes.data(), 4);
+  uint32_t cpu_hz;
+  uint16_t count;
+  memcpy(&cpu_hz, &bytes[4], 4);
+  memcpy(&count, &bytes[8], 2);
+  memcpy(&lost, &bytes[10], 4);
+  TEST_ASSERT_EQUAL_UINT32(240000000, cpu_hz);
+
+  size_t pos = 14;
+  uint8_t spans = bytes[pos++];
+  TEST_ASSERT_EQUAL(TRACE_SPAN_COUNT - 1, spans);
+  for (uint8_t i = 0; i < spans; i++) {
+    std::string name((const char*)&bytes[pos + 2], bytes[pos + 1]);
+    TEST_ASSERT_EQUAL_STRING(Tracer::spanName(bytes[pos]), name.c_str());
+    pos += 2 + bytes[pos + 1];
+  }
+
+  TEST_ASSERT_EQUAL(pos + count * sizeof(TraceEvent), bytes.size());
+  std::vector<TraceEvent> events(count);
+  memcpy(events.data(), &bytes[pos], count * sizeof(TraceEvent));
+  return events;
+}
+
+// Begin/end pairs of one span: duration in us and the end argument
+static std::vector<std::pair<uint32_t, uint8_t>> trace_spans(const std::vector<TraceEvent>& events,
+                                                             uint8_t span) {
+  std::vector<std::pair<uint32_t, uint8_t>> spans;
+  std::vector<uint32_t> open;
+  for (const TraceEvent& event : events) {
+    if (event.span != span) continue;
+    if (event.phase == TRACE_BEGIN) {
+      open.push_back(event.cycles);
+    } else if (event.phase == TRACE_END && !open.empty()) {
+      spans.push_back({(event.cycles - open.back()) / 240, event.arg});
+      open.pop_back();
+    }
+  }
+  TEST_ASSERT_TRUE(open.empty());
+  return spans;
+}
+
+// Spans around the hot paths, dumped and decoded
+void test_trace() {
+  add_office_aps();
+  WiFi.disconnect();
+  bench_begin();
+  tracer.setEnabled(true);
+  tracer.clear();
+
+  WiFiSelector selector(&display, &pref);
+  uint32_t t0 = host::now_ms();
+  TEST_ASSERT_EQUAL(40, (int)selector.scanNetworks().size());
+  uint32_t scan_ms = host::now_ms() - t0;
+
+  ConnectionEngine engine;
+  engine.connect("Office-AP-07-Shared-Workspace", "password");
+  while (engine.poll() == CONN_CONNECTING) {
+    delay(1);
+  }
+  TEST_ASSERT_EQUAL(CONN_CONNECTED, engine.getState());
+  engine.end();
+  WiFi.disconnect();
+
+  invalidate_keyboard();
+  draw_keyboard(0, 0, "");
+  draw_keyboard(1, 0, "a");
+
+  ScrollingText scroller;
+  scroller.setDisplayWidth(18, 108);
+  scroller.setScrollDelay(50);
+  scroller.setPauseDelay(0);
+  scroller.setText("Corporate-Guest-Network-5GHz-Floor3");
+  int scroll_steps = 0;
+  for (int frame = 0; frame < 10; frame++) {
+    scroll_steps += scroller.update();
+    delay(20);
+  }
+
+  ByteCapture capture;
+  uint32_t recorded = tracer.getPending();
+  size_t written = tracer.dump(capture);
+  TEST_ASSERT_EQUAL(capture.bytes.size(), written);
+  uint32_t lost;
+  std::vector<TraceEvent> events = parse_trace(capture.bytes, lost);
+  TEST_ASSERT_EQUAL_UINT32(0, lost);
+  TEST_ASSERT_EQUAL_UINT32(recorded, events.size());
+
+  auto scans = trace_spans(events, TRACE_SCAN);
+  TEST_ASSERT_EQUAL(1, (int)scans.size());
+  // scanNetworks() also redraws the list after the last pass
+  TEST_ASSERT_UINT32_WITHIN(50000, scan_ms * 1000, scans[0].first);
+  TEST_ASSERT_EQUAL(40, scans[0].second);
+  auto connects = trace_spans(events, TRACE_CONNECT);
+  TEST_ASSERT_EQUAL(1, (int)connects.size());
+  TEST_ASSERT_UINT32_WITHIN(1000, engine.getElapsedMs() * 1000, connects[0].first);
+  TEST_ASSERT_EQUAL(CONN_CONNECTED, connects[0].second);
+  TEST_ASSERT_EQUAL(2, (int)trace_spans(events, TRACE_KEYBOARD).size());
+  TEST_ASSERT_TRUE(trace_spans(events, TRACE_DISPLAY).size() >= 2);
+  // Frames between steps are not traced
+  TEST_ASSERT_TRUE(scroll_steps >= 2 && scroll_steps < 10);
+  TEST_ASSERT_EQUAL(scroll_steps, (int)trace_spans(events, TRACE_SCROLL).size());
+
+  // Dumped events are not sent again
+  capture.bytes.clear();
+  tracer.dump(capture);
+  TEST_ASSERT_EQUAL(0, (int)parse_trace(capture.bytes, lost).size());
+
+  // Full ring: the newest events are kept, the rest counted
+  for (int i = 0; i < 3 * TRACE_EVENTS; i++) {
+    tracer.record(TRACE_DISPLAY, TRACE_INSTANT, i & 0xFF);
+  }
+  TEST_ASSERT_EQUAL_UINT32(2 * TRACE_EVENTS, tracer.getOverwritten());
+  capture.bytes.clear();
+  tracer.dump(capture);
+  events = parse_trace(capture.bytes, lost);
+  TEST_ASSERT_EQUAL(TRACE_EVENTS, (int)events.size());
+  TEST_ASSERT_EQUAL_UINT32(2 * TRACE_EVENTS, lost);
+  TEST_ASSERT_EQUAL((3 * TRACE_EVENTS - 1) & 0xFF, events.back().arg);
+
+  // Off: a marker is one load
+  tracer.setEnabled(false);
+  uint32_t before = tracer.getRecorded();
+  draw_keyboard(2, 0, "a");
+  TEST_ASSERT_EQUAL_UINT32(before, tracer.getRecorded());
+  tracer.setEnabled(true);
+
+  // Two producers and a dump running together: no torn events
+  bool stop = false;
+  auto producer = [&stop](uint8_t id) {
+    while (!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+      tracer.record(TRACE_SCROLL, TRACE_INSTANT, id);
+    }
+  };
+  uint32_t started = tracer.getRecorded();
+  std::thread first(producer, 1), second(producer, 2);
+  // A loaded host may not schedule the producers before the dumps finish
+  while (tracer.getRecorded() - started < TRACE_EVENTS) {
+    std::this_thread::yield();
+  }
+  uint32_t torn = 0, seen = 0;
+  for (int dump = 0; dump < 200; dump++) {
+    capture.bytes.clear();
+    tracer.dump(capture);
+    for (const TraceEvent& event : parse_trace(capture.bytes, lost)) {
+      if (event.span == 0) continue;  // Rewritten while dumped: dropped, not torn
+      seen++;
+      if (event.span != TRACE_SCROLL || event.phase != TRACE_INSTANT ||
+          (event.arg != 1 && event.arg != 2)) {
+        torn++;
+      }
+    }
+  }
+  __atomic_store_n(&stop, true, __ATOMIC_RELAXED);
+  first.join();
+  second.join();
+  TEST_ASSERT_TRUE(seen > 0);
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+
+  // Cost of one marker pair
+  tracer.clear();
+  const int pairs = 100000;
+  auto c0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < pairs; i++) {
+    TRACE_SCOPE(TRACE_DISPLAY);
+  }
+  auto c1 = std::chrono::steady_clock::now();
+  double pair_ns = std::chrono::duration<double, std::nano>(c1 - c0).count() / pairs;
+  printf("[bench] %-18s events=%-5u bytes=%-6u bytes/event=%zu scope_ns=%.1f\n", "trace",
+         recorded, (unsigned)written, sizeof(TraceEvent), pair_ns);
+  tracer.clear();
+}
+
+static void save_office_network() {
+  host::nvs.clear();
+  pref.begin("wifi-creds");
+  pref.putString("ssid", "Office-AP-07-Shared-Workspace");
+  pref.putString("password", "password");
+  pref.end();
+}
+
+// main.cpp's boot up to the first frame on the network, with the radio
+// started before the display (parallel) or after the RTC read (sequential)
+static void run_boot(bool parallel, BootTimeline& timeline) {
+  host::reset(POT_CENTER);
+  panel.reset();
+  Wire.attach(OLED_I2C_ADDRESS, &panel);
+  WiFi.disconnect();
+  timeline.reset();
+
+  timeline.mark(BOOT_SETUP);
+  Serial.begin(115200);
+  timeline.mark(BOOT_SERIAL);
+  WiFi.mode(WIFI_STA);
+  timeline.mark(BOOT_RADIO_MODE);
+
+  WiFiSelector selector(&display, &pref);
+  bool fast = false;
+  auto start_radio = [&] {
+    fast = selector.startFastConnect();
+    if (!fast) {
+      selector.startScan();
+    }
+    timeline.mark(BOOT_RADIO_STARTED);
+  };
+  if (parallel) {
+    start_radio();
+  }
+
+  TEST_ASSERT_TRUE(display.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS));
+  display.setBusClock(OLED_I2C_CLOCK_HZ);
+  timeline.mark(BOOT_DISPLAY);
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+  display.setCursor(0, 0);
+  display.println("WiFi Display Module");
+  display.println("Initializing...");
+  display.display();
+  timeline.mark(BOOT_SPLASH);
+  display.waitTransfer();
+  TimeService clock;
+  clock.begin();
+  timeline.mark(BOOT_TIME);
+
+  if (!parallel) {
+    start_radio();
+  }
+  bool connected = fast && selector.finishFastConnect();
+  if (!connected) {
+    if (fast) {
+      selector.startScan();
+    }
+    connected = selector.connectWithSavedCredentials(selector.waitForScan());
+  }
+  TEST_ASSERT_TRUE(connected);
+  timeline.mark(BOOT_CONNECTED);
+
+  display.clearDisplay();
+  display.setCursor(0, 0);
+  display.println("WiFi Connected!");
+  display.display();
+  timeline.mark(BOOT_READY);
+  TEST_ASSERT_TRUE(panel.matches(display.getBuffer()));
+}
+
+// Radio started as soon as WiFi.mode() returns, display brought up meanwhile
+void test_parallel_boot() {
+  add_office_aps();
+  Wire.attach(RTC_I2C_ADDRESS, nullptr);
+  BootTimeline sequential, parallel;
+
+  // No channel hint: scan path
+  save_office_network();
+  run_boot(false, sequential);
+  uint32_t scan_sequential_ms = sequential.getMs(BOOT_CONNECTED);
+  uint32_t display_us = sequential.getUs(BOOT_TIME) - sequential.getUs(BOOT_RADIO_MODE);
+  save_office_network();
+  run_boot(true, parallel);
+  uint32_t scan_parallel_ms = parallel.getMs(BOOT_CONNECTED);
+
+  // Hint saved by the scan path: fast reconnect
+  run_boot(false, sequential);
+  uint32_t fast_sequential_ms = sequential.getMs(BOOT_CONNECTED);
+  run_boot(true, parallel);
+  uint32_t fast_parallel_ms = parallel.getMs(BOOT_CONNECTED);
+
+  printf("[bench] %-18s display_bringup_ms=%.1f fast_path_ms=%u/%u scan_path_ms=%u/%u\n",
+         "parallel_boot", display_us / 1000.0, fast_sequential_ms, fast_parallel_ms,
+         scan_sequential_ms, scan_parallel_ms);
+  ByteCapture report;
+  parallel.report(report);
+  std::string line(report.bytes.begin(), report.bytes.end());
+  TEST_ASSERT_TRUE(line.find(" radio_started=0 ") != std::string::npos);
+  TEST_ASSERT_TRUE(line.find(" ready=" + std::to_string(parallel.getReadyMs()) + " ms") != std::string::npos);
+
+  // The radio was handed its work before the display came up, and the
+  // display time no longer adds to boot-to-IP
+  for (uint8_t phase = 1; phase < BOOT_PHASE_COUNT; phase++) {
+    TEST_ASSERT_TRUE(parallel.reached((BootPhase)phase));
+  }
+  TEST_ASSERT_TRUE(parallel.getUs(BOOT_RADIO_STARTED) <= parallel.getUs(BOOT_DISPLAY));
+  TEST_ASSERT_TRUE(sequential.getUs(BOOT_RADIO_STARTED) >= sequential.getUs(BOOT_TIME));
+  TEST_ASSERT_TRUE(display_us > 10000);
+  TEST_ASSERT_TRUE((fast_sequential_ms - fast_parallel_ms) * 1000 + 2000 >= display_us);
+  // Later scan passes start on the next frame either way; the first one overlaps
+  TEST_ASSERT_TRUE(scan_parallel_ms < scan_sequential_ms);
+}
+
+// Best of a few runs of one operation, the host is shared
+template <typename Op>
+static double best_ns(int rounds, Op op) {
+  double best = 1e18;
+  for (int run = 0; run < 5; run++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      op();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    best = min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / rounds);
+  }
+  return best;
+}
+
+// Page-aligned text against the Adafruit GFX pixel path it replaces
+static Adafruit_SSD1306 gfx_reference(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET_PIN);
+
+// drawChar() is not virtual in Adafruit GFX: each driver is called through its own type
+template <typename Display>
+static void draw_all_glyphs(Display& gfx, int16_t y, uint16_t color, uint16_t bg) {
+  uint8_t* buffer = gfx.getBuffer();
+  for (size_t i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT / 8; i++) buffer[i] = (uint8_t)(i * 37 + (i >> 7));
+  for (int c = FONT5X7_FIRST; c < FONT5X7_FIRST + FONT5X7_GLYPHS; c++) {
+    int i = c - FONT5X7_FIRST;
+    gfx.drawChar((i % 22) * 6 - 3, y + (i / 22) * 8, c, color, bg, 1, 1);
+  }
+  gfx.drawChar(125, 0, 'W', color, bg, 1, 1);
+}
+
+void test_font_render() {
+  bench_begin();
+  gfx_reference.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS);
+  const size_t size = SCREEN_WIDTH * SCREEN_HEIGHT / 8;
+  const uint16_t colors[][2] = {
+    {SSD1306_WHITE, SSD1306_WHITE}, {SSD1306_BLACK, SSD1306_BLACK}, {SSD1306_INVERSE, SSD1306_INVERSE},
+    {SSD1306_WHITE, SSD1306_BLACK}, {SSD1306_BLACK, SSD1306_WHITE}, {SSD1306_INVERSE, SSD1306_BLACK}
+  };
+
+  // Every printable glyph in every mode over a patterned background, clipped
+  // at both edges; y=13 and the last pair take the GFX fallback
+  for (const auto& pair : colors) {
+    for (int16_t y : {8, 13}) {
+      draw_all_glyphs(display, y, pair[0], pair[1]);
+      draw_all_glyphs(gfx_reference, y, pair[0], pair[1]);
+      TEST_ASSERT_EQUAL_MEMORY(gfx_reference.getBuffer(), display.getBuffer(), size);
+    }
+  }
+
+  // print() wraps and advances like GFX, and drawText() matches it
+  for (Adafruit_SSD1306* gfx : {(Adafruit_SSD1306*)&display, &gfx_reference}) {
+    gfx->clearDisplay();
+    gfx->setTextSize(1);
+    gfx->setTextColor(SSD1306_WHITE);
+    gfx->setCursor(0, 0);
+    gfx->print("Corporate-Guest-Network-5GHz\nFloor 3");
+    gfx->setTextColor(SSD1306_BLACK, SSD1306_WHITE);
+    gfx->setCursor(60, 32);
+    gfx->print(" Connect ");
+    gfx->setTextSize(2);
+    gfx->setCursor(0, 48);
+    gfx->print("Big");
+  }
+  TEST_ASSERT_EQUAL_MEMORY(gfx_reference.getBuffer(), display.getBuffer(), size);
+  TEST_ASSERT_EQUAL(114, display.drawTextInverse(60, 32, " Connect "));
+  TEST_ASSERT_EQUAL_MEMORY(gfx_reference.getBuffer(), display.getBuffer(), size);
+
+  gfx_reference.setTextSize(1);
+  display.setTextSize(1);
+  static int line;
+  double gfx_ns = best_ns(5000, [] {
+    gfx_reference.setCursor(0, (line++ & 7) * 8);
+    gfx_reference.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
+    gfx_reference.print("Corporate-Guest-Net");
+  });
+  line = 0;
+  double page_ns = best_ns(5000, [] {
+    display.setCursor(0, (line++ & 7) * 8);
+    display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
+    display.print("Corporate-Guest-Net");
+  });
+  printf("[bench] %-18s gfx_ns/line=%-8.0f page_ns/line=%-8.0f speedup=%.1fx\n",
+         "font_render", gfx_ns, page_ns, gfx_ns / page_ns);
+  TEST_ASSERT_EQUAL_MEMORY(gfx_reference.getBuffer(), display.getBuffer(), size);
+  TEST_ASSERT_TRUE(gfx_ns > page_ns * 10);
+}
+
+// Word-wise rectangle kernels against the GFX pixel loops they replace
+static uint32_t kernel_seed = 1;
+static int16_t kernel_random(int16_t low, int16_t high) {
+  kernel_seed = kernel_seed * 1103515245 + 12345;
+  return low + (int16_t)((kernel_seed >> 16) % (uint32_t)(high - low + 1));
+}
+
+static bool page_pixel(const PageBuffer& frame, int16_t x, int16_t y) {
+  return frame.data[x + (y >> 3) * frame.width] & (1 << (y & 7));
+}
+
+// The cursor moving over every key: highlight on, then off again, like draw_key()
+template <typename Display>
+static void highlight_keys(Display& gfx) {
+  for (uint8_t row = 0; row < KEY_GRID_ROWS; row++) {
+    for (uint8_t col = 0; col < 18; col++) {
+      int16_t x = col * 7, y = KEY_GRID_Y + row * KEY_PITCH_Y;
+      gfx.fillRect(x, y, 7, KEY_PITCH_Y, SSD1306_WHITE);
+      gfx.drawChar(x + 1, y, 'a' + col, SSD1306_BLACK, SSD1306_WHITE, 1, 1);
+      gfx.fillRect(x, y, 7, KEY_PITCH_Y, SSD1306_BLACK);
+      gfx.drawChar(x + 1, y, 'a' + col, SSD1306_WHITE, SSD1306_BLACK, 1, 1);
+    }
+  }
+}
+
+// Text line and scroller strip cleared, a list row inverted on and off
+template <typename Display>
+static void clear_rows(Display& gfx) {
+  gfx.fillRect(0, 8, SCREEN_WIDTH, 8, SSD1306_BLACK);
+  gfx.fillRect(36, 16, 108, 8, SSD1306_BLACK);
+  gfx.fillRect(0, 13, SCREEN_WIDTH, 9, SSD1306_INVERSE);
+  gfx.fillRect(0, 13, SCREEN_WIDTH, 9, SSD1306_INVERSE);
+}
+
+void test_page_kernels() {
+  bench_begin();
+  gfx_reference.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS);
+  const size_t size = SCREEN_WIDTH * SCREEN_HEIGHT / 8;
+  for (size_t i = 0; i < size; i++) {
+    display.getBuffer()[i] = gfx_reference.getBuffer()[i] = (uint8_t)(i * 37 + (i >> 7));
+  }
+
+  // Fills in every color, partial pages and clipping on all sides
+  const uint16_t colors[] = {SSD1306_WHITE, SSD1306_BLACK, SSD1306_INVERSE};
+  for (int i = 0; i < 2000; i++) {
+    int16_t x = kernel_random(-20, 130), y = kernel_random(-12, 66);
+    int16_t w = kernel_random(-2, 140), h = kernel_random(-2, 70);
+    uint16_t color = colors[i % 3];
+    display.fillRect(x, y, w, h, color);
+    gfx_reference.fillRect(x, y, w, h, color);
+  }
+  TEST_ASSERT_EQUAL_MEMORY(gfx_reference.getBuffer(), display.getBuffer(), size);
+
+  // Copies at every vertical bit offset, checked pixel by pixel
+  static uint8_t source_data[40 * 3];
+  for (size_t i = 0; i < sizeof(source_data); i++) source_data[i] = (uint8_t)(i * 73 + 11);
+  PageBuffer source = {source_data, 40, 20};
+  static uint8_t before_data[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+  PageBuffer before = {before_data, SCREEN_WIDTH, SCREEN_HEIGHT};
+  PageBuffer frame = display.pages();
+  for (int i = 0; i < 500; i++) {
+    int16_t sx = kernel_random(-5, 40), sy = kernel_random(-5, 20);
+    int16_t dx = kernel_random(-10, 128), dy = kernel_random(-10, 64);
+    int16_t w = kernel_random(0, 45), h = kernel_random(0, 25);
+    memcpy(before_data, frame.data, size);
+    display.copyRect(dx, dy, source, sx, sy, w, h);
+    for (int16_t y = 0; y < SCREEN_HEIGHT; y++) {
+      for (int16_t x = 0; x < SCREEN_WIDTH; x++) {
+        int16_t u = x - dx + sx, v = y - dy + sy;
+        bool inside = x >= dx && x < dx + w && y >= dy && y < dy + h &&
+                      u >= 0 && u < source.width && v >= 0 && v < source.height;
+        bool expected = inside ? page_pixel(source, u, v) : page_pixel(before, x, y);
+        TEST_ASSERT_TRUE(page_pixel(frame, x, y) == expected);
+      }
+    }
+  }
+
+  // Opaque scrolling text is the transparent strip over a cleared or filled window
+  ScrollingText scroller(18, 108, 0, 0);
+  scroller.enableSmoothScroll(true, 6);
+  scroller.setText("Corporate-Guest-Network-5GHz-Floor3");
+  static uint8_t expected[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+  for (int step = 0; step < 250; step++) {
+    scroller.update();
+    int16_t x = (step % 5) * 7 - 10, y = 13 + step % 11;
+    uint16_t fg = (step & 1) ? SSD1306_BLACK : SSD1306_WHITE;
+    uint16_t bg = (step & 1) ? SSD1306_WHITE : SSD1306_BLACK;
+    gfx_reference.fillRect(x, y, 108, 8, bg);
+    memcpy(display.getBuffer(), gfx_reference.getBuffer(), size);
+    scroller.draw(&display, x, y, 1, fg);
+    memcpy(expected, display.getBuffer(), size);
+    scroller.drawWithBackground(&display, x, y, 1, fg, bg);
+    TEST_ASSERT_EQUAL_MEMORY(expected, display.getBuffer(), size);
+    delay(1);
+  }
+
+  // Ratios are reported, not asserted: wall-clock time on a shared host is
+  // noisy. A key cell is 7 columns, too narrow for whole words, so its gain
+  // comes from byte masks and page glyphs alone
+  double gfx_highlight_ns = best_ns(200, [] { highlight_keys(gfx_reference); });
+  double word_highlight_ns = best_ns(200, [] { highlight_keys(display); });
+  double gfx_clear_ns = best_ns(5000, [] { clear_rows(gfx_reference); });
+  double word_clear_ns = best_ns(5000, [] { clear_rows(display); });
+  printf("[bench] %-18s highlight_ns/key=%.0f/%.0f (%.1fx) clear_ns/row=%.0f/%.0f (%.1fx)\n",
+         "page_kernels", gfx_highlight_ns / 108, word_highlight_ns / 108,
+         gfx_highlight_ns / word_highlight_ns, gfx_clear_ns / 4, word_clear_ns / 4,
+         gfx_clear_ns / word_clear_ns);
+  TEST_ASSERT_EQUAL_MEMORY(gfx_reference.getBuffer(), display.getBuffer(), size);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_scrolling_text);
+  RUN_TEST(test_scrolling_render_cost);
+  RUN_TEST(test_draw_keyboard);
+  RUN_TEST(test_keyboard_layouts);
+  RUN_TEST(test_prompt_keyboard);
+  RUN_TEST(test_keyinput_poll);
+  RUN_TEST(test_axis_repeat);
+  RUN_TEST(test_button_events);
+  RUN_TEST(test_progressive_scan);
+  RUN_TEST(test_scan_collector);
+  RUN_TEST(test_network_list);
+  RUN_TEST(test_network_selection);
+  RUN_TEST(test_frame_scheduler);
+  RUN_TEST(test_fast_reconnect);
+  RUN_TEST(test_credential_store);
+  RUN_TEST(test_connection_engine);
+  RUN_TEST(test_task_runtime);
+  RUN_TEST(test_async_display);
+  RUN_TEST(test_sleep_cycle);
+  RUN_TEST(test_uplink);
+  RUN_TEST(test_rtc_time);
+  RUN_TEST(test_trace);
+  RUN_TEST(test_parallel_boot);
+  RUN_TEST(test_font_render);
+  RUN_TEST(test_page_kernels);
+  return UNITY_END();
+}
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Trace Decoder for WiFi Display Module
+Reads Serial captures holding Tracer dumps (TRACE_DUMP=1), prints per-span
+duration histograms and writes a Chrome trace (chrome://tracing, Perfetto)
+"""
+
+import argparse
+import json
+import struct
+import sys
+import time
+from pathlib import Path
+
+MAGIC = b'TRC1'
+EVENT = struct.Struct('<IIBBBB')  # cycles, ms, span, phase, core, arg
+TRACE_BEGIN, TRACE_END, TRACE_INSTANT = 0, 1, 2
+
+def parse_dumps(data):
+    """Return every dump in a capture; text logged around them is skipped"""
+    dumps = []
+    offset = data.find(MAGIC)
+    while offset >= 0:
+        try:
+            dump, end = parse_dump(data, offset)
+        except (struct.error, IndexError):
+            print(f"Warning: truncated dump at byte {offset}", file=sys.stderr)
+            break
+        dumps.append(dump)
+        offset = data.find(MAGIC, end)
+    return dumps
+
+def parse_dump(data, offset):
+    """Decode one dump starting at its magic; returns (dump, end offset)"""
+    pos = offset + len(MAGIC)
+    cpu_hz, count, lost = struct.unpack_from('<IHI', data, pos)
+    pos += 10
+    span_count = data[pos]
+    pos += 1
+
+    names = {}
+    for _ in range(span_count):
+        span, length = data[pos], data[pos + 1]
+        names[span] = data[pos + 2:pos + 2 + length].decode('ascii', 'replace')
+        pos += 2 + length
+
+    events = []
+    for _ in range(count):
+        cycles, ms, span, phase, core, arg = EVENT.unpack_from(data, pos)
+        pos += EVENT.size
+        if span:  # 0: slot rewritten while it was dumped
+            events.append({'cycles': cycles, 'ms': ms, 'span': span,
+                           'phase': phase, 'core': core, 'arg': arg})
+
+    add_timestamps(events, cpu_hz)
+    return {'cpu_hz': cpu_hz, 'lost': lost, 'names': names, 'events': events}, pos
+
+def add_timestamps(events, cpu_hz):
+    """Microseconds since boot from the 32-bit cycle counters.
+
+    Each core has its own counter, so each is anchored to millis() at its
+    first event (cores line up to within a millisecond). millis() also picks
+    the number of counter wraps, which keeps long gaps (scans, connects) right.
+    """
+    anchors = {}
+    for event in events:
+        core = event['core']
+        if core not in anchors:
+            anchors[core] = (event['cycles'], event['ms'])
+        base_cycles, base_ms = anchors[core]
+
+        delta = (event['cycles'] - base_cycles) & 0xFFFFFFFF
+        expected = (event['ms'] - base_ms) * cpu_hz / 1000
+        wraps = round((expected - delta) / 2**32)
+        event['us'] = base_ms * 1000 + (delta + wraps * 2**32) * 1e6 / cpu_hz
+
+def pair_spans(events):
+    """Match begin and end events into (span, core, start us, duration us, arg)"""
+    spans = []
+    open_spans = {}
+    for event in sorted(events, key=lambda e: e['us']):
+        key = (event['span'], event['core'])
+        if event['phase'] == TRACE_BEGIN:
+            open_spans.setdefault(key, []).append(event)
+        elif event['phase'] == TRACE_END:
+            stack = open_spans.get(key)
+            if not stack:
+                # Ended on the other core (a task that migrated)
+                stack = next((s for (span, _), s in open_spans.items()
+                              if span == event['span'] and s), None)
+            if stack:
+                begin = stack.pop()
+                spans.append((event['span'], begin['core'], begin['us'],
+                              event['us'] - begin['us'], event['arg']))
+    return spans
+
+def percentile(values, fraction):
+    return values[min(len(values) - 1, int(len(values) * fraction))]
+
+def print_histograms(dumps):
+    """Duration statistics and log2 buckets per span, over all dumps"""
+    durations = {}
+    names = {}
+    for dump in dumps:
+        names.update(dump['names'])
+        for span, _, _, duration, _ in pair_spans(dump['events']):
+            durations.setdefault(span, []).append(duration)
+
+    lost = sum(dump['lost'] for dump in dumps)
+    print(f"{len(dumps)} dump(s), {sum(len(d['events']) for d in dumps)} events, {lost} overwritten")
+    for span in sorted(durations):
+        values = sorted(durations[span])
+        print(f"\n{names.get(span, span)}: n={len(values)} total={sum(values) / 1000:.1f} ms "
+              f"min={values[0]:.0f} p50={percentile(values, 0.5):.0f} "
+              f"p90={percentile(values, 0.9):.0f} p99={percentile(values, 0.99):.0f} "
+              f"max={values[-1]:.0f} us")
+
+        buckets = {}
+        for value in values:
+            bucket = max(0, int(value).bit_length() - 1)
+            buckets[bucket] = buckets.get(bucket, 0) + 1
+        peak = max(buckets.values())
+        for bucket in range(min(buckets), max(buckets) + 1):
+            count = buckets.get(bucket, 0)
+            low = 0 if bucket == 0 else 1 << bucket
+            bar = '#' * (count * 40 // peak) if count else ''
+            print(f"  {low:>9} us+ {count:>6} {bar}")
+
+def chrome_trace(dumps):
+    """Trace Event Format: one process per dump (wake), one thread per core"""
+    trace = []
+    for pid, dump in enumerate(dumps):
+        names = dump['names']
+        trace.append({'name': 'process_name', 'ph': 'M', 'pid': pid,
+                      'args': {'name': f"wake {pid}"}})
+        for span, core, start, duration, arg in pair_spans(dump['events']):
+            trace.append({'name': names.get(span, str(span)), 'cat': 'span', 'ph': 'X',
+                          'ts': round(start, 3), 'dur': round(duration, 3),
+                          'pid': pid, 'tid': core, 'args': {'arg': arg}})
+        for event in dump['events']:
+            if event['phase'] == TRACE_INSTANT:
+                trace.append({'name': names.get(event['span'], str(event['span'])),
+                              'cat': 'mark', 'ph': 'i', 's': 't', 'ts': round(event['us'], 3),
+                              'pid': pid, 'tid': event['core'], 'args': {'arg': event['arg']}})
+    return {'traceEvents': trace, 'displayTimeUnit': 'ms'}
+
+def read_port(port, baud, seconds):
+    """Capture raw Serial bytes (needs pyserial)"""
+    import serial
+    data = bytearray()
+    deadline = time.time() + seconds
+    with serial.Serial(port, baud, timeout=0.2) as link:
+        while time.time() < deadline:
+            data += link.read(4096)
+    return bytes(data)
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', nargs='?', help="raw Serial capture file")
+    parser.add_argument('--port', help="read from a serial port instead (e.g. /dev/ttyUSB0)")
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--seconds', type=float, default=30, help="how long to read the port")
+    parser.add_argument('--chrome', default='trace.json', help="Chrome trace output path")
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_port(args.port, args.baud, args.seconds)
+    elif args.capture:
+        data = Path(args.capture).read_bytes()
+    else:
+        parser.error("give a capture file or --port")
+
+    dumps = parse_dumps(data)
+    if not dumps:
+        print("Error: no trace dump found (is TRACE_DUMP=1?)", file=sys.stderr)
+        return 1
+
+    print_histograms(dumps)
+    with open(args.chrome, 'w') as f:
+        json.dump(chrome_trace(dumps), f)
+    print(f"\nChrome trace written to {args.chrome}")
+    return 0
+
+if __name__ == '__main__':
+    exit(main())